@@ -0,0 +1,38 @@
+import os
+import sys
+import argparse
+
+from benchmarks import startup, lexer, frontend, parser, methods
+
+BENCHMARKS = {
+    "startup": startup.run,
+    "lexer": lexer.run,
+    "frontend": frontend.run,
+    "parser": parser.run,
+    "methods": methods.run,
+}
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("compiler", help="Path to the shtkc executable")
+    parser.add_argument("benchmarks", nargs="*", help=f"Benchmarks to run, all by default: {' '.join(BENCHMARKS)}")
+    parser.add_argument("--runs", type=int, default=20)
+    args = parser.parse_args()
+
+    names = args.benchmarks or list(BENCHMARKS.keys())
+
+    for name in names:
+        if name not in BENCHMARKS:
+            print(f"Unknown benchmark {name}")
+            return 1
+
+    for name in names:
+        BENCHMARKS[name](os.path.abspath(args.compiler), args.runs)
+        print()
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
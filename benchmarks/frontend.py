@@ -0,0 +1,56 @@
+from typing import Dict, List
+
+import os
+import subprocess
+
+from benchmarks.timing import print_header, print_row, phase_wall_time, compiler_tests_dir
+
+# Lexing and parsing every file of the compiler tests, a corpus of small and medium sized real programs
+
+PHASES = ["Lexing", "Parsing"]
+
+
+def corpus_files() -> List[str]:
+    # Files testing compile errors stop before -time-phases prints anything, so they are left out
+    files = []
+
+    for file_name in sorted(os.listdir(compiler_tests_dir())):
+        if not file_name.endswith(".shtk") or file_name.endswith("Error.shtk"):
+            continue
+
+        files.append(file_name)
+
+    return files
+
+
+def time_phases(compiler: str, file_name: str) -> Dict[str, float]:
+    subp = subprocess.run([compiler, file_name, "-ast", "-time-phases"],
+                          cwd=compiler_tests_dir(), stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+
+    if subp.returncode != 0:
+        return {}
+
+    output = subp.stdout.decode("utf-8")
+    return {phase: phase_wall_time(output, phase) for phase in PHASES}
+
+
+def run(compiler: str, runs: int) -> None:
+    files = corpus_files()
+    timings: Dict[str, List[float]] = {phase: [] for phase in PHASES + ["Total"]}
+
+    for _ in range(runs):
+        totals = {phase: 0.0 for phase in PHASES}
+
+        for file_name in files:
+            for phase, wall_time in time_phases(compiler, file_name).items():
+                totals[phase] += wall_time
+
+        for phase in PHASES:
+            timings[phase].append(totals[phase])
+
+        timings["Total"].append(sum(totals.values()))
+
+    print_header(f"Frontend ({len(files)} files)")
+
+    for phase, phase_timings in timings.items():
+        print_row(phase, phase_timings)
@@ -0,0 +1,66 @@
+from typing import List
+
+import os
+import subprocess
+import tempfile
+
+from benchmarks.timing import print_header, print_row, phase_wall_time
+
+# A function using most kinds of tokens, repeated with a different name to create large source files
+
+FUNCTION_TEMPLATE = """
+# Synthetic function {index}
+fn compute{index}(values: int[], count: int, scale: float) -> float
+{{
+    var total: float = 0.0
+    var mask := 0xff00 | 0b1010
+    const message := "value of \\"compute{index}\\" is"
+
+    for i in range(0, count)
+    {{
+        if values[i] >= 128 and not (values[i] & mask == 0)
+            total += float`(values[i]) * scale / 2.5
+        else if values[i] <= -1 or i % 3 == 0
+            total -= 1.0
+        else
+            continue
+    }}
+
+    println(message, total)
+    return total
+}}
+"""
+
+LINES_PER_FUNCTION = FUNCTION_TEMPLATE.count("\n")
+
+SIZES = [1000, 5000]
+
+
+def create_source(directory: str, function_count: int) -> str:
+    file_name = os.path.join(directory, f"Synthetic{function_count}.shtk")
+
+    with open(file_name, "w") as source_file:
+        for index in range(function_count):
+            source_file.write(FUNCTION_TEMPLATE.format(index=index))
+
+    return file_name
+
+
+def run(compiler: str, runs: int) -> None:
+    print_header("Lexer")
+
+    with tempfile.TemporaryDirectory() as directory:
+        for function_count in SIZES:
+            file_name = create_source(directory, function_count)
+            timings: List[float] = []
+
+            for _ in range(runs):
+                subp = subprocess.run([compiler, os.path.basename(file_name), "-ast", "-time-phases"],
+                                      cwd=directory, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+
+                if subp.returncode != 0:
+                    raise RuntimeError(f"Could not compile {file_name}")
+
+                timings.append(phase_wall_time(subp.stdout.decode("utf-8"), "Lexing"))
+
+            print_row(f"{function_count * LINES_PER_FUNCTION} lines", timings)
@@ -0,0 +1,85 @@
+from typing import List
+
+import os
+import subprocess
+import tempfile
+
+from benchmarks.timing import print_header, print_row, phase_wall_time
+
+# Method calls, constructors and custom operators on a struct of the module being compiled, every call
+# used to copy the whole module description, so generating large modules took quadratic time
+
+STRUCT_SOURCE = """
+struct Counter
+{
+    var value: int
+}
+
+fn createCounter(value: int) -> Counter
+{
+    var counter: Counter
+    counter.value = value
+    return counter
+}
+
+fn increment(mut self: Counter, amount: int)
+{
+    self.value += amount
+}
+
+fn get(self: Counter) -> int
+{
+    return self.value
+}
+
+fn __add__(LHS: Counter, RHS: Counter) -> Counter
+{
+    return createCounter(LHS.value + RHS.value)
+}
+"""
+
+FUNCTION_TEMPLATE = """
+fn compute{index}(start: int) -> int
+{{
+    var counter := make(Counter, start)
+    counter.increment({index})
+    const total := counter + counter
+    return total.get()
+}}
+"""
+
+SIZES = [100, 500]
+
+
+def create_source(directory: str, function_count: int) -> str:
+    file_name = os.path.join(directory, f"Methods{function_count}.shtk")
+
+    with open(file_name, "w") as source_file:
+        source_file.write(STRUCT_SOURCE)
+
+        for index in range(function_count):
+            source_file.write(FUNCTION_TEMPLATE.format(index=index))
+
+        source_file.write("\nfn main() -> int\n{\n    println(compute0(1))\n    return 0\n}\n")
+
+    return file_name
+
+
+def run(compiler: str, runs: int) -> None:
+    print_header("Methods")
+
+    with tempfile.TemporaryDirectory() as directory:
+        for function_count in SIZES:
+            file_name = create_source(directory, function_count)
+            timings: List[float] = []
+
+            for _ in range(runs):
+                subp = subprocess.run([compiler, os.path.basename(file_name), "-icode", "-time-phases"],
+                                      cwd=directory, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+
+                if subp.returncode != 0:
+                    raise RuntimeError(f"Could not compile {file_name}")
+
+                timings.append(phase_wall_time(subp.stdout.decode("utf-8"), "Function generation"))
+
+            print_row(f"{function_count} functions calling methods", timings)
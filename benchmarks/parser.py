@@ -0,0 +1,57 @@
+from typing import Callable, List
+
+import os
+import subprocess
+import tempfile
+
+from benchmarks.timing import print_header, print_row, phase_wall_time
+
+# Deeply nested expressions like the ones emitted by code generators, parsing these used to take
+# quadratic time because every subscript scanned ahead for its matching bracket
+
+
+def nested_subscripts(depth: int) -> str:
+    return "a[" * depth + "0" + "]" * depth
+
+
+def nested_parentheses(depth: int) -> str:
+    return "(" * depth + "1" + ")" * depth
+
+
+def nested_generic_calls(depth: int) -> str:
+    return "f[int](" * depth + "0" + ")" * depth
+
+
+CASES: List[Callable[[int], str]] = [nested_subscripts, nested_parentheses, nested_generic_calls]
+
+DEPTHS = [250, 500, 1000]
+
+
+def create_source(directory: str, case: Callable[[int], str], depth: int) -> str:
+    file_name = os.path.join(directory, f"{case.__name__}{depth}.shtk")
+
+    with open(file_name, "w") as source_file:
+        source_file.write(f"fn main() -> int\n{{\n    println({case(depth)})\n    return 0\n}}\n")
+
+    return file_name
+
+
+def run(compiler: str, runs: int) -> None:
+    print_header("Parser")
+
+    with tempfile.TemporaryDirectory() as directory:
+        for case in CASES:
+            for depth in DEPTHS:
+                file_name = create_source(directory, case, depth)
+                timings: List[float] = []
+
+                for _ in range(runs):
+                    subp = subprocess.run([compiler, os.path.basename(file_name), "-ast", "-time-phases"],
+                                          cwd=directory, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+
+                    if subp.returncode != 0:
+                        raise RuntimeError(f"Could not parse {file_name}")
+
+                    timings.append(phase_wall_time(subp.stdout.decode("utf-8"), "Parsing"))
+
+                print_row(f"{case.__name__.replace('_', ' ')}, depth {depth}", timings)
@@ -0,0 +1,20 @@
+from benchmarks.timing import time_command, print_header, print_row, compiler_tests_dir
+
+# Small programs, where setting up LLVM is a large part of the compile time
+
+STARTUP_CASES = [
+    ["Println.shtk", "-c"],
+    ["Println.shtk", "-release"],
+    ["Println.shtk", "-linux-arm64"],
+    ["TestModules/Math.shtk", "-c"],
+    ["TestModules/Math.shtk", "-release"],
+    ["TestModules/Math.shtk", "-c", "-j", "2"],
+]
+
+
+def run(compiler: str, runs: int) -> None:
+    print_header("Startup")
+
+    for case in STARTUP_CASES:
+        timings = time_command([compiler] + case, compiler_tests_dir(), runs)
+        print_row(" ".join(case), timings)
@@ -0,0 +1,40 @@
+from typing import List
+
+import os
+import statistics
+import subprocess
+import time
+
+
+def time_command(command: List[str], cwd: str, runs: int) -> List[float]:
+    timings = []
+
+    for _ in range(runs):
+        start = time.perf_counter()
+        subp = subprocess.run(command, cwd=cwd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        timings.append(time.perf_counter() - start)
+
+        if subp.returncode != 0:
+            raise RuntimeError(f"{' '.join(command)} failed in {cwd}")
+
+    return timings
+
+
+def print_header(title: str) -> None:
+    print(f"{title:<48}{'min (ms)':>12}{'median (ms)':>14}")
+
+
+def print_row(name: str, timings: List[float]) -> None:
+    print(f"{name:<48}{min(timings) * 1000:>12.2f}{statistics.median(timings) * 1000:>14.2f}")
+
+
+def phase_wall_time(output: str, phase_name: str) -> float:
+    for line in output.splitlines():
+        if line.startswith(phase_name):
+            return float(line[len(phase_name):].split()[0]) / 1000
+
+    raise RuntimeError(f"Phase {phase_name} not found in -time-phases output")
+
+
+def compiler_tests_dir() -> str:
+    return os.path.join(os.getcwd(), "compiler/tests/compiler")
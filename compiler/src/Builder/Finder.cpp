@@ -46,19 +46,19 @@ ModuleDescription* Finder::getModuleFromToken(const Token& aliasToken)
     return &modulesMap.at(moduleName);
 }
 
-StructDescription Finder::getStructDescFromType(const TypeDescription& type)
+const StructDescription& Finder::getStructDescFromType(const TypeDescription& type)
 {
     return modulesMap.at(type.moduleName).structures.at(type.dtypeName);
 }
 
-StructDescription Finder::getStructDescFromUnit(const Unit& unit)
+const StructDescription& Finder::getStructDescFromUnit(const Unit& unit)
 {
     return getStructDescFromType(unit.type());
 }
 
 std::vector<TypeDescription> Finder::getFieldTypes(const TypeDescription& type)
 {
-    const StructDescription structDescription = getStructDescFromType(type);
+    const StructDescription& structDescription = getStructDescFromType(type);
 
     std::vector<TypeDescription> fieldTypes;
 
@@ -75,7 +75,7 @@ std::vector<std::string> Finder::getFieldNames(const TypeDescription& type)
 
 std::vector<TypeDescription> Finder::destructureStructType(const TypeDescription& type)
 {
-    const StructDescription structDescription = getStructDescFromType(type);
+    const StructDescription& structDescription = getStructDescFromType(type);
 
     std::vector<TypeDescription> types;
 
@@ -87,7 +87,7 @@ std::vector<TypeDescription> Finder::destructureStructType(const TypeDescription
 
 std::map<std::string, TypeDescription> Finder::destructureStructTypeMapped(const TypeDescription& type)
 {
-    const StructDescription structDescription = getStructDescFromType(type);
+    const StructDescription& structDescription = getStructDescFromType(type);
 
     std::map<std::string, TypeDescription> typeMap;
 
@@ -110,14 +110,14 @@ bool Finder::getLocal(const Token& nameToken, Unit& returnValue)
 
 bool Finder::getGlobal(const Token& nameToken, Unit& returnValue)
 {
-    std::string mangledGlobalName = nameMangle(nameToken, rootModule.name);
+    SymbolId mangledGlobalName;
 
-    TypeDescription typeDescription;
-
-    if (!rootModule.getGlobal(mangledGlobalName, typeDescription))
+    if (!rootModule.getDefinedGlobal(nameToken.toString(), mangledGlobalName))
         return false;
 
-    returnValue = unitBuilder.unitFromTypeDescription(typeDescription, mangledGlobalName);
+    const TypeDescription& typeDescription = rootModule.globals.find(mangledGlobalName)->second;
+
+    returnValue = unitBuilder.unitFromTypeDescription(typeDescription, symbolName(mangledGlobalName));
     return true;
 }
 
@@ -194,28 +194,28 @@ Unit Finder::getUnitFromToken(const Token& nameToken)
     console.compileErrorOnToken("Symbol does not exist", nameToken);
 }
 
-FunctionDescription Finder::getFunction(const Token& nameToken)
+const FunctionDescription& Finder::getFunction(const Token& nameToken)
 {
-    FunctionDescription functionDescription;
+    const FunctionDescription* functionDescription;
 
     std::string incompleteFunctionModule;
     if (workingModule->getIncompleteFunctionModule(nameToken.toString(), incompleteFunctionModule))
         return workingModule->externFunctions.at(nameMangle(nameToken, incompleteFunctionModule));
 
     if (workingModule->getExternFunction(nameToken.toString(), functionDescription))
-        return functionDescription;
+        return *functionDescription;
 
-    if (workingModule->getFunction(nameMangle(nameToken, workingModule->name), functionDescription))
-        return functionDescription;
+    if (workingModule->getDefinedFunction(nameToken.toString(), functionDescription))
+        return *functionDescription;
 
     if (workingModule->getFunction(nameToken.toString(), functionDescription))
-        return functionDescription;
+        return *functionDescription;
 
-    if (rootModule.getFunction(nameMangle(nameToken, rootModule.name), functionDescription))
-        return functionDescription;
+    if (rootModule.getDefinedFunction(nameToken.toString(), functionDescription))
+        return *functionDescription;
 
     if (rootModule.getExternFunction(nameToken.toString(), functionDescription))
-        return functionDescription;
+        return *functionDescription;
 
     console.compileErrorOnToken("Function does not exist", nameToken);
 }
@@ -240,8 +240,8 @@ bool isSameParamsType(const FunctionDescription& function, const std::vector<Uni
 
     for (size_t i = 0; i < params.size(); i += 1)
     {
-        const TypeDescription actualParamType = params[i].type();
-        const TypeDescription formalParamType = function.getParamTypePos(i);
+        const TypeDescription& actualParamType = params[i].type();
+        const TypeDescription& formalParamType = function.getParamTypePos(i);
 
         if (!isSameTypeDescription(formalParamType, actualParamType))
             return false;
@@ -250,13 +250,18 @@ bool isSameParamsType(const FunctionDescription& function, const std::vector<Uni
     return true;
 }
 
-FunctionDescription Finder::getFunctionByParamTypes(const Token& token,
-                                                    const TypeDescription& type,
-                                                    const std::vector<Unit>& params)
+const FunctionDescription& Finder::getFunctionByParamTypes(const Token& token,
+                                                           const TypeDescription& type,
+                                                           const std::vector<Unit>& params)
 {
-    for (auto functionName : workingModule->definedFunctions)
+    const std::vector<std::string>* functionNames;
+
+    if (!workingModule->functionsByReturnType.get(type.dtypeName, functionNames))
+        console.compileErrorOnToken("Cannot find function with matching params", token);
+
+    for (const std::string& functionName : *functionNames)
     {
-        const FunctionDescription function = workingModule->functions.at(functionName);
+        const FunctionDescription& function = workingModule->functions.at(functionName);
 
         if (!isSameTypeDescription(function.functionReturnType, type))
             continue;
@@ -281,26 +286,34 @@ bool isSameParamsTypeFixedDim(const FunctionDescription& function, const std::ve
     if (!isSameParamsType(function, { params[0], params[1] }))
         return false;
 
-    const TypeDescription secondFormalParam = function.getParamTypePos(1);
+    const TypeDescription& secondFormalParam = function.getParamTypePos(1);
 
     return secondFormalParam.isArrayWithFixedDim();
 }
 
-FunctionDescription Finder::getCustomOperatorFunction(const std::string& binaryOperatorName,
-                                                      const std::vector<Unit>& params,
-                                                      const Token& errorToken)
+const FunctionDescription& Finder::getCustomOperatorFunction(const std::string& binaryOperatorName,
+                                                             const std::vector<Unit>& params,
+                                                             const Token& errorToken)
 {
-    for (auto functionName : workingModule->definedFunctions)
-    {
-        const std::string unmangleFunctionName = unMangleString(functionName, workingModule->name);
+    const FunctionDescription* function;
 
-        if (unmangleFunctionName.rfind(binaryOperatorName, 0) != 0)
-            continue;
+    /* The hook named exactly after the operator is tried before the ones with a suffix,
+        so < does not call __lessThanOrEqual__ */
+    if (workingModule->getDefinedFunction(binaryOperatorName + "__", function))
+        if (isSameParamsType(*function, params) || isSameParamsTypeFixedDim(*function, params))
+            return *function;
 
-        const FunctionDescription function = workingModule->functions.at(functionName);
+    const std::vector<std::string>* hookNames;
 
-        if (isSameParamsType(function, params) || isSameParamsTypeFixedDim(function, params))
-            return function;
+    if (workingModule->hookFunctions.get(binaryOperatorName, hookNames))
+    {
+        for (const std::string& functionName : *hookNames)
+        {
+            function = &workingModule->functions.at(functionName);
+
+            if (isSameParamsType(*function, params) || isSameParamsTypeFixedDim(*function, params))
+                return *function;
+        }
     }
 
     console.operatorError(errorToken, params[0], params[1]);
@@ -311,7 +324,7 @@ bool Finder::isAllNamesStructFields(const std::vector<Token>& nameTokens, const
     if (!type.isStruct())
         return false;
 
-    const StructDescription structDescription = getStructDescFromType(type);
+    const StructDescription& structDescription = getStructDescFromType(type);
 
     for (auto& nameToken : nameTokens)
         if (!structDescription.fieldExists(nameToken.toString()))
@@ -328,21 +341,16 @@ bool Finder::deconstructorExists(const icode::TypeDescription& type)
     return getStructDescFromType(type).deconstructor != "";
 }
 
-std::string getMangledMethodName(const TypeDescription& type, const std::string& method)
-{
-    return nameMangleString(method, type.moduleName);
-}
-
 bool Finder::methodExists(const icode::TypeDescription& type, const std::string& method)
 {
-    icode::ModuleDescription typeModule = modulesMap.at(type.moduleName);
+    const icode::ModuleDescription& typeModule = modulesMap.at(type.moduleName);
 
-    icode::FunctionDescription function;
+    const icode::FunctionDescription* function;
 
-    if (!typeModule.getFunction(getMangledMethodName(type, method), function))
+    if (!typeModule.getDefinedFunction(method, function))
         return false;
 
-    if (!isSameTypeDescription(function.getParamTypePos(0), getBaseType(type)))
+    if (!isSameTypeDescription(function->getParamTypePos(0), getBaseType(type)))
         return false;
 
     return true;
@@ -350,27 +358,32 @@ bool Finder::methodExists(const icode::TypeDescription& type, const std::string&
 
 bool Finder::functionExists(const icode::TypeDescription& type, const std::string& function)
 {
-    icode::ModuleDescription typeModule = modulesMap.at(type.moduleName);
-    return typeModule.functionExists(getMangledMethodName(type, function));
+    const icode::ModuleDescription& typeModule = modulesMap.at(type.moduleName);
+
+    const icode::FunctionDescription* functionDescription;
+    return typeModule.getDefinedFunction(function, functionDescription);
 }
 
-FunctionDescription Finder::getMethod(const TypeDescription& type, const std::string& method)
+const FunctionDescription& Finder::getMethod(const TypeDescription& type, const std::string& method)
 {
-    const std::string mangledFunctionName = getMangledMethodName(type, method);
-    const icode::ModuleDescription typeModule = modulesMap.at(type.moduleName);
+    const icode::ModuleDescription& typeModule = modulesMap.at(type.moduleName);
+
+    const icode::FunctionDescription* function;
+    if (!typeModule.getDefinedFunction(method, function))
+        console.internalBugError();
 
-    return typeModule.functions.at(mangledFunctionName);
+    return *function;
 }
 
-FunctionDescription Finder::getMethodFromUnit(const Unit& unit, const std::string& method, const Token& errorToken)
+const FunctionDescription& Finder::getMethodFromUnit(const Unit& unit,
+                                                     const std::string& method,
+                                                     const Token& errorToken)
 {
-    const TypeDescription type = unit.type();
-    const std::string mangledFunctionName = getMangledMethodName(type, method);
-    icode::ModuleDescription typeModule = modulesMap.at(type.moduleName);
+    const icode::ModuleDescription& typeModule = modulesMap.at(unit.moduleName());
 
-    icode::FunctionDescription function;
-    if (!typeModule.getFunction(mangledFunctionName, function))
+    const icode::FunctionDescription* function;
+    if (!typeModule.getDefinedFunction(method, function))
         console.compileErrorOnToken("Method " + method + " does not exist", errorToken);
 
-    return function;
+    return *function;
 }
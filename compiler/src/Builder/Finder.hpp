@@ -8,6 +8,7 @@
 #include "Unit.hpp"
 #include "UnitBuilder.hpp"
 
+/* Descriptions are returned by reference into the modules map, which never moves its elements */
 class Finder
 {
     icode::ModuleDescription& rootModule;
@@ -40,9 +41,9 @@ public:
 
     icode::ModuleDescription* getModuleFromToken(const Token& moduleNameToken);
 
-    icode::StructDescription getStructDescFromType(const icode::TypeDescription& type);
+    const icode::StructDescription& getStructDescFromType(const icode::TypeDescription& type);
 
-    icode::StructDescription getStructDescFromUnit(const Unit& unit);
+    const icode::StructDescription& getStructDescFromUnit(const Unit& unit);
 
     std::vector<icode::TypeDescription> getFieldTypes(const icode::TypeDescription& type);
 
@@ -54,17 +55,17 @@ public:
 
     Unit getUnitFromToken(const Token& nameToken);
 
-    icode::FunctionDescription getFunction(const Token& nameToken);
+    const icode::FunctionDescription& getFunction(const Token& nameToken);
 
     std::vector<Unit> getFormalParameters(const icode::FunctionDescription& function);
 
-    icode::FunctionDescription getFunctionByParamTypes(const Token& token,
-                                                       const icode::TypeDescription& type,
-                                                       const std::vector<Unit>& params);
+    const icode::FunctionDescription& getFunctionByParamTypes(const Token& token,
+                                                              const icode::TypeDescription& type,
+                                                              const std::vector<Unit>& params);
 
-    icode::FunctionDescription getCustomOperatorFunction(const std::string& binaryOperatorName,
-                                                         const std::vector<Unit>& params,
-                                                         const Token& errorToken);
+    const icode::FunctionDescription& getCustomOperatorFunction(const std::string& binaryOperatorName,
+                                                                const std::vector<Unit>& params,
+                                                                const Token& errorToken);
 
     bool isAllNamesStructFields(const std::vector<Token>& nameTokens, const icode::TypeDescription& type);
 
@@ -74,9 +75,11 @@ public:
 
     bool functionExists(const icode::TypeDescription& type, const std::string& method);
 
-    icode::FunctionDescription getMethod(const icode::TypeDescription& type, const std::string& method);
+    const icode::FunctionDescription& getMethod(const icode::TypeDescription& type, const std::string& method);
 
-    icode::FunctionDescription getMethodFromUnit(const Unit& unit, const std::string& method, const Token& errorToken);
+    const icode::FunctionDescription& getMethodFromUnit(const Unit& unit,
+                                                        const std::string& method,
+                                                        const Token& errorToken);
 };
 
 #endif
\ No newline at end of file
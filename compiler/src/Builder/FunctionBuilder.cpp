@@ -373,7 +373,7 @@ Operand FunctionBuilder::addressMultiplyOperator(Operand op2, Operand op3)
 
 Unit FunctionBuilder::getStructFieldFromString(const std::string& fieldName, const Unit& unit)
 {
-    StructDescription structDescription = finder.getStructDescFromUnit(unit);
+    const StructDescription& structDescription = finder.getStructDescFromUnit(unit);
 
     TypeDescription fieldType = structDescription.structFields.at(fieldName);
 
@@ -403,7 +403,7 @@ Unit FunctionBuilder::getStructFieldFromString(const std::string& fieldName, con
 
 Unit FunctionBuilder::getStructField(const Token& fieldNameToken, const Unit& unit)
 {
-    StructDescription structDescription = finder.getStructDescFromUnit(unit);
+    const StructDescription& structDescription = finder.getStructDescFromUnit(unit);
 
     const std::string fieldName = fieldNameToken.toString();
 
@@ -463,7 +463,7 @@ std::vector<Unit> FunctionBuilder::destructureStruct(const Unit& unit)
 {
     std::vector<Unit> destructuredUnits;
 
-    const StructDescription structDescription = finder.getStructDescFromUnit(unit);
+    const StructDescription& structDescription = finder.getStructDescFromUnit(unit);
 
     for (const std::string& fieldName : structDescription.fieldNames)
         destructuredUnits.push_back(getStructFieldFromString(fieldName, unit));
@@ -489,7 +489,7 @@ std::map<std::string, Unit> FunctionBuilder::destructureStructMapped(const Unit&
 {
     std::map<std::string, Unit> mappedDestructuredUnits;
 
-    const StructDescription structDescription = finder.getStructDescFromUnit(unit);
+    const StructDescription& structDescription = finder.getStructDescFromUnit(unit);
 
     for (auto field : structDescription.structFields)
         mappedDestructuredUnits[field.first] = getStructFieldFromString(field.first, unit);
@@ -621,7 +621,9 @@ Operand FunctionBuilder::createPointerForPassAddress(const Unit& actualParam, co
     return tempArray.op();
 }
 
-void FunctionBuilder::passParameter(FunctionDescription callee, const Unit& formalParam, const Unit& actualParam)
+void FunctionBuilder::passParameter(const FunctionDescription& callee,
+                                    const Unit& formalParam,
+                                    const Unit& actualParam)
 {
     DataType functionDataType = callee.functionReturnType.dtype;
 
@@ -734,10 +736,10 @@ bool FunctionBuilder::shouldCallResourceMgmtHook(const Unit& unit, const std::st
 
 void FunctionBuilder::callResourceMgmtHookSingle(const Unit& symbol, const std::string& hook)
 {
-    const icode::FunctionDescription deconstructorFunction = finder.getMethod(symbol.type(), hook);
+    const icode::FunctionDescription& deconstructorFunction = finder.getMethod(symbol.type(), hook);
 
     const std::string formalName = deconstructorFunction.parameters[0];
-    const TypeDescription formalType = deconstructorFunction.getParamTypePos(0);
+    const TypeDescription& formalType = deconstructorFunction.getParamTypePos(0);
     const Unit formalParam = unitBuilder.unitFromTypeDescription(formalType, formalName);
 
     passParameter(deconstructorFunction, formalParam, symbol);
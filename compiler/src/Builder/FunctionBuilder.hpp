@@ -109,7 +109,7 @@ public:
 
     Unit createLocal(const Token nameToken, icode::TypeDescription& typeDescription);
 
-    void passParameter(icode::FunctionDescription callee,
+    void passParameter(const icode::FunctionDescription& callee,
                        const Unit& formalParam,
                        const Unit& actualParam); 
 
@@ -56,6 +56,13 @@ void IRBuilder::setWorkingFunction(const Token& functionNameToken, bool externC)
         workingFunction = &rootModule.functions.at(mangledFunctionName);
     }
 
+    setWorkingFunction(workingFunction);
+}
+
+void IRBuilder::setWorkingFunction(icode::FunctionDescription* functionDescription)
+{
+    workingFunction = functionDescription;
+
     functionBuilder.setWorkingFunction(workingFunction);
     finder.setWorkingFunction(workingFunction);
 }
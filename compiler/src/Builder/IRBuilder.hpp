@@ -35,6 +35,9 @@ public:
 
     void setWorkingFunction(const Token& functionNameToken, bool externC);
 
+    /* For generating a function into a description that is not in the modules map yet */
+    void setWorkingFunction(icode::FunctionDescription* functionDescription);
+
     IRBuilder(icode::StringModulesMap& modules_map, const std::string& file_name, Console& console);
 };
 
@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <cctype>
+#include <set>
 
 #include "NameMangle.hpp"
 
@@ -10,6 +12,8 @@ ModuleBuilder::ModuleBuilder(ModuleDescription& rootModule, StringModulesMap& mo
     : rootModule(rootModule)
     , modulesMap(modulesMap)
     , console(console)
+    , stringDataModulesFixed(false)
+    , deferredStringData(nullptr)
 {
 }
 
@@ -76,9 +80,9 @@ TypeInformation ModuleBuilder::getTypeInformation(const Token& dataTypeToken, Da
     if (dtype != icode::STRUCT)
         return TypeInformation{ getDataTypeSize(dtype), workingModule->name, false };
 
-    icode::StructDescription structDesc;
+    const icode::StructDescription* structDesc;
     if (workingModule->getStruct(dataTypeName, structDesc))
-        return TypeInformation{ structDesc.size, structDesc.moduleName, false };
+        return TypeInformation{ structDesc->size, structDesc->moduleName, false };
 
     std::string incompleteTypeModuleName;
     if (workingModule->getIncompleteTypeModule(dataTypeName, incompleteTypeModuleName))
@@ -129,37 +133,98 @@ std::string unescapedStringFromTokens(const std::vector<Token>& tokens)
     return str;
 }
 
-std::string ModuleBuilder::createMultilineStringData(const std::vector<Token>& tokens)
+std::set<std::string> getTransitiveUses(const StringModulesMap& modulesMap, const ModuleDescription& module)
+{
+    std::set<std::string> visited = { module.name };
+    std::vector<std::string> stack = module.uses;
+
+    while (stack.size() != 0)
+    {
+        const std::string moduleName = stack.back();
+        stack.pop_back();
+
+        auto moduleIterator = modulesMap.find(moduleName);
+
+        if (visited.count(moduleName) != 0 || moduleIterator == modulesMap.end())
+            continue;
+
+        visited.insert(moduleName);
+        stack.insert(stack.end(), moduleIterator->second.uses.begin(), moduleIterator->second.uses.end());
+    }
+
+    return visited;
+}
+
+std::string ModuleBuilder::findOrCreateStringData(const std::string& key, const std::string& str)
 {
     /* Check if this string has already been defined, if yes return the key for that,
-        else create a new key (across all modules) */
-    std::string str = unescapedStringFromTokens(tokens);
+        else create the new key. Only strings of this module and the modules it uses are
+        reused, those modules are always linked together with this module */
+
+    if (!stringDataModulesFixed)
+        stringDataModules = getTransitiveUses(modulesMap, rootModule);
 
-    for (auto modulesMapItem : modulesMap)
+    for (const auto& modulesMapItem : modulesMap)
     {
+        if (stringDataModules.count(modulesMapItem.first) == 0)
+            continue;
+
         auto result = std::find_if(modulesMapItem.second.stringsData.begin(),
                                    modulesMapItem.second.stringsData.end(),
-                                   [str](const auto& mapItem) { return mapItem.second == str; });
+                                   [&str](const auto& mapItem) { return mapItem.second == str; });
 
         if (result != modulesMapItem.second.stringsData.end())
         {
-            const std::string key = result->first;
-            rootModule.stringsDataCharCounts[key] = modulesMapItem.second.stringsDataCharCounts[key];
-            return key;
+            const std::string& foundKey = result->first;
+            rootModule.stringsDataCharCounts[foundKey] = modulesMapItem.second.stringsDataCharCounts.at(foundKey);
+            return foundKey;
         }
     }
 
-    std::string key = lineColNameMangle(tokens[0], rootModule.name);
     rootModule.stringsData[key] = str;
     rootModule.stringsDataCharCounts[key] = str.size();
 
     return key;
 }
 
+std::string ModuleBuilder::createMultilineStringData(const std::vector<Token>& tokens, int& charCount)
+{
+    const std::string str = unescapedStringFromTokens(tokens);
+    const std::string key = lineColNameMangle(tokens[0], rootModule.name);
+
+    charCount = str.size();
+
+    if (deferredStringData == nullptr)
+        return findOrCreateStringData(key, str);
+
+    /* Nothing is added to the module until the string is resolved, so workers do not write to it */
+    deferredStringData->push_back({ key, str });
+
+    return key;
+}
+
+void ModuleBuilder::fixStringDataModules()
+{
+    stringDataModules = getTransitiveUses(modulesMap, rootModule);
+    stringDataModulesFixed = true;
+}
+
+void ModuleBuilder::deferStringData(std::vector<std::pair<std::string, std::string>>* stringData)
+{
+    deferredStringData = stringData;
+}
+
+std::string ModuleBuilder::resolveDeferredStringData(const std::string& key, const std::string& str)
+{
+    return findOrCreateStringData(key, str);
+}
+
 std::string ModuleBuilder::createStringData(const Token& stringToken)
 {
     const std::vector<Token> stringTokens = { stringToken };
-    return createMultilineStringData(stringTokens);
+
+    int charCount;
+    return createMultilineStringData(stringTokens, charCount);
 }
 
 void ModuleBuilder::createStringDefine(const Token& nameToken, const Token& valueToken)
@@ -231,7 +296,7 @@ bool ModuleBuilder::isValidDeconstructor(const icode::FunctionDescription& funct
     if (function.numParameters() != 1)
         return false;
 
-    const TypeDescription symbolType = function.getParamTypePos(0);
+    const TypeDescription& symbolType = function.getParamTypePos(0);
 
     if (rootModule.name != symbolType.moduleName)
         return false;
@@ -244,6 +309,21 @@ void ModuleBuilder::setDeconstructor(const TypeDescription& type, const std::str
     rootModule.structures.at(type.dtypeName).deconstructor = mangledFunctionName;
 }
 
+void ModuleBuilder::indexHookFunction(const std::string& functionName, const std::string& mangledFunctionName)
+{
+    if (functionName.size() < 5 || functionName.rfind("__", 0) != 0)
+        return;
+
+    const size_t nameEnd = functionName.size() - 2;
+
+    if (functionName.compare(nameEnd, 2, "__") != 0)
+        return;
+
+    for (size_t i = 3; i <= nameEnd; i += 1)
+        if (i == nameEnd || isupper(functionName[i]))
+            rootModule.hookFunctions[functionName.substr(0, i)].push_back(mangledFunctionName);
+}
+
 void ModuleBuilder::createFunction(const Token& nameToken,
                                    const icode::TypeDescription& returnType,
                                    const std::vector<Token>& paramNames,
@@ -267,6 +347,11 @@ void ModuleBuilder::createFunction(const Token& nameToken,
     }
 
     rootModule.functions[mangledFunctionName] = function;
+    rootModule.mangledNames[functionName] = internSymbol(mangledFunctionName);
+
+    indexHookFunction(functionName, mangledFunctionName);
+
+    rootModule.functionsByReturnType[returnType.dtypeName].push_back(mangledFunctionName);
 
     rootModule.definedFunctions.push_back(mangledFunctionName);
 }
@@ -331,6 +416,7 @@ void ModuleBuilder::createGlobal(const Token globalNameToken, icode::TypeDescrip
     typeDescription.setProperty(IS_GLOBAL);
 
     rootModule.globals[mangledGlobalName] = typeDescription;
+    rootModule.mangledNames[globalNameToken.toString()] = internSymbol(mangledGlobalName);
 }
 
 icode::StructDescription ModuleBuilder::createEmptyStructDescription()
@@ -396,11 +482,25 @@ void ModuleBuilder::createUse(const Token& pathToken, const Token& aliasToken)
     rootModule.aliases[alias] = path;
 }
 
+FunctionDescription getFunctionDeclaration(const FunctionDescription& function)
+{
+    /* Copy everything except the icode */
+    FunctionDescription declaration;
+
+    declaration.functionReturnType = function.functionReturnType;
+    declaration.parameters = function.parameters;
+    declaration.symbols = function.symbols;
+    declaration.moduleName = function.moduleName;
+    declaration.absoluteName = function.absoluteName;
+
+    return declaration;
+}
+
 void ModuleBuilder::createFrom(const std::string& moduleName, const Token& symbolNameToken)
 {
     /* Used to store return values */
-    StructDescription structDescReturnValue;
-    FunctionDescription funcDescReturnValue;
+    const StructDescription* structDescReturnValue;
+    const FunctionDescription* funcDescReturnValue;
     long intDefineReturnValue;
     double floatDefineReturnValue;
     EnumDescription enumReturnValue;
@@ -412,22 +512,18 @@ void ModuleBuilder::createFrom(const std::string& moduleName, const Token& symbo
     /* Import symbol */
 
     const std::string symbolString = symbolNameToken.toString();
-    const std::string mangledSymbolString = nameMangle(symbolNameToken, externalModule->name);
 
     if (rootModule.symbolExists(symbolString))
         console.compileErrorOnToken("Symbol already exists", symbolNameToken);
 
     if (externalModule->getStruct(symbolString, structDescReturnValue))
-        rootModule.structures[symbolString] = structDescReturnValue;
+        rootModule.structures[symbolString] = *structDescReturnValue;
 
     else if (externalModule->getExternFunction(symbolString, funcDescReturnValue))
-        rootModule.externFunctions[symbolString] = funcDescReturnValue;
+        rootModule.externFunctions[symbolString] = *funcDescReturnValue;
 
-    else if (externalModule->getFunction(mangledSymbolString, funcDescReturnValue))
-    {
-        funcDescReturnValue.icodeTable.clear();
-        rootModule.externFunctions[symbolString] = funcDescReturnValue;
-    }
+    else if (externalModule->getDefinedFunction(symbolString, funcDescReturnValue))
+        rootModule.externFunctions[symbolString] = getFunctionDeclaration(*funcDescReturnValue);
 
     else if (externalModule->getIntDefine(symbolString, intDefineReturnValue))
         rootModule.intDefines[symbolString] = intDefineReturnValue;
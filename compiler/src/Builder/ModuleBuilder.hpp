@@ -1,6 +1,8 @@
 #ifndef BUILDER_MODULE_BUILDER
 #define BUILDER_MODULE_BUILDER
 
+#include <set>
+
 #include "../Console/Console.hpp"
 #include "../IntermediateRepresentation/All.hpp"
 
@@ -19,6 +21,13 @@ class ModuleBuilder
 
     icode::ModuleDescription* workingModule;
 
+    std::set<std::string> stringDataModules;
+    bool stringDataModulesFixed;
+
+    std::vector<std::pair<std::string, std::string>>* deferredStringData;
+
+    std::string findOrCreateStringData(const std::string& key, const std::string& str);
+
     icode::StructDescription createEmptyStructDescription();
 
     TypeInformation getTypeInformation(const Token& dataTypeToken, icode::DataType dtype);
@@ -35,6 +44,8 @@ class ModuleBuilder
 
     void setDeconstructor(const icode::TypeDescription& type, const std::string& mangledFunctionName);
 
+    void indexHookFunction(const std::string& functionName, const std::string& mangledFunctionName);
+
     void createUseNoAlias(const Token& pathToken);
 
     void createEnumType(const Token& nameToken);
@@ -56,7 +67,19 @@ public:
 
     void createFloatDefine(const Token& nameToken, float value);
 
-    std::string createMultilineStringData(const std::vector<Token>& tokens);
+    /* charCount is the length of the string, a worker can not look it up by the key before the string
+        is resolved */
+    std::string createMultilineStringData(const std::vector<Token>& tokens, int& charCount);
+
+    /* Strings of function bodies are reused only from the modules used when function generation starts,
+        so a key does not depend on which generics a function before it instantiated */
+    void fixStringDataModules();
+
+    /* Used on workers, a string literal then gets the key of its own position and is appended to
+        stringData. resolveDeferredStringData gives the key it ends up with, called in function order */
+    void deferStringData(std::vector<std::pair<std::string, std::string>>* stringData);
+
+    std::string resolveDeferredStringData(const std::string& key, const std::string& str);
 
     std::string createStringData(const Token& stringToken);
 
@@ -7,6 +7,16 @@ OperandBuilder::OperandBuilder()
     idCounter = 0;
 }
 
+void OperandBuilder::setIdCounter(unsigned int id)
+{
+    idCounter = id;
+}
+
+unsigned int OperandBuilder::getIdCounter() const
+{
+    return idCounter;
+}
+
 unsigned int OperandBuilder::getId()
 {
     return idCounter++;
@@ -46,7 +56,7 @@ Operand OperandBuilder::createStringDataOperand(const std::string& name, unsigne
 {
     Operand temp;
     temp.operandId = getId();
-    temp.name = name;
+    temp.name = internSymbol(name);
     temp.operandType = STR_DATA;
     temp.val.size = size;
     temp.dtype = icode::UI8;
@@ -69,7 +79,7 @@ Operand OperandBuilder::createVarOperand(DataType dtype, const std::string& name
 {
     Operand temp;
     temp.operandId = getId();
-    temp.name = name;
+    temp.name = internSymbol(name);
     temp.dtype = dtype;
     temp.operandType = type;
 
@@ -142,7 +152,7 @@ Operand OperandBuilder::createLabelOperand(const std::string& label)
 {
     Operand temp;
     temp.operandId = getId();
-    temp.name = label;
+    temp.name = internSymbol(label);
     temp.operandType = LABEL;
 
     return temp;
@@ -152,7 +162,7 @@ Operand OperandBuilder::createModuleOperand(const std::string& module)
 {
     Operand temp;
     temp.operandId = getId();
-    temp.name = module;
+    temp.name = internSymbol(module);
     temp.operandType = MODULE;
 
     return temp;
@@ -10,6 +10,12 @@ class OperandBuilder
 public:
     OperandBuilder();
 
+    /* Workers generating functions of a module in parallel number operands from their own first id,
+        the ids are moved into the sequence of the module once all functions are generated */
+    void setIdCounter(unsigned int id);
+
+    unsigned int getIdCounter() const;
+
     unsigned int getId();
 
     icode::Operand createTempOperand(icode::DataType dtype);
@@ -2,7 +2,7 @@
 
 using namespace icode;
 
-bool isSameDim(TypeDescription type1, TypeDescription type2)
+bool isSameDim(const TypeDescription& type1, const TypeDescription& type2)
 {
     if (type1.dimensions.size() != type2.dimensions.size())
         return false;
@@ -39,6 +39,9 @@ bool isSameTypeDescription(const TypeDescription& type1, const TypeDescription&
 
 bool isSameType(const Unit& unit1, const Unit& unit2)
 {
+    if (unit1.typeId() == unit2.typeId())
+        return true;
+
     if (unit1.isStringLtrl() && unit2.isStringLtrl())
         return true;
 
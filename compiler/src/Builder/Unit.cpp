@@ -2,17 +2,20 @@
 
 using namespace icode;
 
-Unit::Unit() {}
+Unit::Unit()
+{
+    typeHandle = EMPTY_TYPE;
+}
 
 Unit::Unit(const TypeDescription& type, const Operand& operand)
 {
     this->operand = operand;
-    this->typeDescription = type;
+    this->typeHandle = internType(type);
 }
 
 Unit::Unit(const TypeDescription& type, const std::vector<Unit>& list)
 {
-    this->typeDescription = type;
+    this->typeHandle = internType(type);
     this->list = list;
 };
 
@@ -36,38 +39,46 @@ std::vector<Unit> Unit::flatten() const
 
 Unit Unit::clearProperties()
 {
+    TypeDescription typeDescription = type();
     typeDescription.properties &= 1 << IS_PTR;
+
+    typeHandle = internType(typeDescription);
     return *this;
 }
 
-std::string Unit::moduleName() const
+const std::string& Unit::moduleName() const
 {
-    return typeDescription.moduleName;
+    return type().moduleName;
 }
 
 DataType Unit::dtype() const
 {
-    return typeDescription.dtype;
+    return type().dtype;
 }
 
 std::string Unit::name() const
 {
-    return operand.name;
+    return symbolName(operand.name);
+}
+
+const std::string& Unit::dtypeName() const
+{
+    return type().dtypeName;
 }
 
-std::string Unit::dtypeName() const
+const std::vector<int>& Unit::dimensions() const
 {
-    return typeDescription.dtypeName;
+    return type().dimensions;
 }
 
-std::vector<int> Unit::dimensions() const
+const TypeDescription& Unit::type() const
 {
-    return typeDescription.dimensions;
+    return internedType(typeHandle);
 }
 
-TypeDescription Unit::type() const
+TypeId Unit::typeId() const
 {
-    return typeDescription;
+    return typeHandle;
 }
 
 Operand Unit::op() const
@@ -82,97 +93,97 @@ std::vector<Unit> Unit::destructureUnitList() const
 
 unsigned int Unit::size() const
 {
-    return typeDescription.size;
+    return type().size;
 }
 
 unsigned int Unit::dtypeSize() const
 {
-    return typeDescription.dtypeSize;
+    return type().dtypeSize;
 }
 
 unsigned int Unit::numElements() const
 {
-    return typeDescription.numElements();
+    return type().numElements();
 }
 
 bool Unit::isStringLtrl() const
 {
-    return typeDescription.checkProperty(IS_STRING_LTRL);
+    return type().checkProperty(IS_STRING_LTRL);
 }
 
 bool Unit::isChar() const
 {
-    return typeDescription.dtype == UI8;
+    return type().dtype == UI8;
 }
 
 bool Unit::isMutable() const
 {
-    return typeDescription.isMutable();
+    return type().isMutable();
 }
 
 bool Unit::isIntegerType() const
 {
-    return typeDescription.isIntegerType();
+    return type().isIntegerType();
 }
 
 bool Unit::isFloatType() const
 {
-    return typeDescription.isFloatType();
+    return type().isFloatType();
 }
 
 bool Unit::isEnum() const
 {
-    return typeDescription.isEnum();
+    return type().isEnum();
 }
 
 bool Unit::isStruct() const
 {
-    return typeDescription.isStruct();
+    return type().isStruct();
 }
 
 bool Unit::isArray() const
 {
-    return typeDescription.isArray();
+    return type().isArray();
 }
 
 bool Unit::isStructOrArray() const
 {
-    return typeDescription.isStructOrArray();
+    return type().isStructOrArray();
 }
 
 bool Unit::isStructOrArrayAndNotPointer() const
 {
-    return typeDescription.isStructOrArrayAndNotPointer();
+    return type().isStructOrArrayAndNotPointer();
 }
 
 bool Unit::isMultiDimArray() const
 {
-    return typeDescription.isMultiDimArray();
+    return type().isMultiDimArray();
 }
 
 bool Unit::isSingleDimCharArray() const
 {
-    return typeDescription.dimensions.size() == 1 && isChar();
+    return type().dimensions.size() == 1 && isChar();
 }
 
 bool Unit::isArrayWithFixedDim() const
 {
-    return isList() || typeDescription.isArrayWithFixedDim();
+    return isList() || type().isArrayWithFixedDim();
 }
 
 bool Unit::isLocal() const
 {
-    return typeDescription.checkProperty(IS_LOCAL);
+    return type().checkProperty(IS_LOCAL);
 }
 
 bool Unit::isGlobal() const
 {
-    return typeDescription.checkProperty(IS_GLOBAL);
+    return type().checkProperty(IS_GLOBAL);
 }
 
 bool Unit::isParam() const
 {
-    return typeDescription.isParam();
+    return type().isParam();
 }
 
 bool Unit::isLocalOrGlobal() const
@@ -212,12 +223,12 @@ bool Unit::isUserPointer() const
 
 bool Unit::isMutableAndPointer() const
 {
-    return typeDescription.isMutableAndPointer();
+    return type().isMutableAndPointer();
 }
 
 bool Unit::isMutableOrPointer() const
 {
-    return typeDescription.isMutableOrPointer();
+    return type().isMutableOrPointer();
 }
 
 bool Unit::isLiteral() const
@@ -5,10 +5,11 @@
 
 #include "../IntermediateRepresentation/Operand.hpp"
 #include "../IntermediateRepresentation/TypeDescription.hpp"
+#include "../IntermediateRepresentation/TypeTable.hpp"
 
 class Unit
 {
-    icode::TypeDescription typeDescription;
+    icode::TypeId typeHandle;
     icode::Operand operand;
     std::vector<Unit> list;
 
@@ -19,13 +20,14 @@ public:
     std::vector<Unit> flatten() const;
     Unit clearProperties();
 
-    std::string moduleName() const;
+    const std::string& moduleName() const;
 
     icode::DataType dtype() const;
     std::string name() const;
-    std::string dtypeName() const;
-    std::vector<int> dimensions() const;
-    icode::TypeDescription type() const;
+    const std::string& dtypeName() const;
+    const std::vector<int>& dimensions() const;
+    const icode::TypeDescription& type() const;
+    icode::TypeId typeId() const;
     icode::Operand op() const;
     std::vector<Unit> destructureUnitList() const;
 
@@ -85,8 +85,11 @@ int UnitBuilder::getCharCountFromStringDataKey(const std::string& key)
 
 Unit UnitBuilder::unitFromStringDataKey(const std::string& key)
 {
-    int charCount = getCharCountFromStringDataKey(key);
+    return unitFromStringData(key, getCharCountFromStringDataKey(key));
+}
 
+Unit UnitBuilder::unitFromStringData(const std::string& key, int charCount)
+{
     std::vector<int> dimensions;
     dimensions.push_back(charCount);
 
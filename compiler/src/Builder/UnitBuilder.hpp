@@ -26,6 +26,7 @@ public:
     Unit unitFromTypeDescription(const icode::TypeDescription& typeDescription, const std::string& name);
     Unit unitFromUnitList(const std::vector<Unit>& unitList);
     Unit unitFromStringDataKey(const std::string& key);
+    Unit unitFromStringData(const std::string& key, int charCount);
 };
 
 #endif
\ No newline at end of file
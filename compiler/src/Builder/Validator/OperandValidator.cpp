@@ -5,43 +5,43 @@
 void validateNoneOperand(const icode::Operand& op, Console& con)
 {
     con.check(op.dtype == icode::VOID);
-    con.check(op.name.size() == 0);
+    con.check(op.name == icode::EMPTY_SYMBOL);
 }
 
 void validateTempOrLiteralOperand(const icode::Operand& op, Console& con)
 {
     con.check(nonVoidBaseDataType(op));
-    con.check(op.name.size() == 0);
+    con.check(op.name == icode::EMPTY_SYMBOL);
 }
 
 void validateTempPtrOperand(const icode::Operand& op, Console& con)
 {
     con.check(validDataType(op));
-    con.check(op.name.size() == 0);
+    con.check(op.name == icode::EMPTY_SYMBOL);
 }
 
 void validateStrDataOperand(const icode::Operand& op, Console& con)
 {
     con.check(op.dtype == icode::UI8);
-    con.check(op.name.size() != 0);
+    con.check(op.name != icode::EMPTY_SYMBOL);
 }
 
 void validateNameOperand(const icode::Operand& op, Console& con)
 {
     con.check(op.dtype == icode::VOID);
-    con.check(op.name.size() != 0);
+    con.check(op.name != icode::EMPTY_SYMBOL);
 }
 
 void validateVaOrPtrOperand(const icode::Operand& op, Console& con)
 {
     con.check(validDataType(op));
-    con.check(op.name.size() != 0);
+    con.check(op.name != icode::EMPTY_SYMBOL);
 }
 
 void validateRetOperand(const icode::Operand& op, Console& con)
 {
     con.check(validDataType(op));
-    con.check(op.name.size() == 0);
+    con.check(op.name == icode::EMPTY_SYMBOL);
 }
 
 void validateOperand(const icode::Operand& op, Console& con)
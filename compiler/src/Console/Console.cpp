@@ -21,15 +21,45 @@ void Console::printModuleStack()
         pp::println(fileNameStack[i]);
 }
 
+const source::SourceFile& Console::getTokenSource(const Token& tok)
+{
+    /* Generated tokens do not belong to any file, an empty source is used for them */
+    static const source::SourceFile emptySource;
+
+    auto sourcePair = sourcesMap.find(tok.getFileName());
+
+    if (sourcePair == sourcesMap.end())
+        return emptySource;
+
+    return *sourcePair->second;
+}
+
+bool Console::claimErrorOutput()
+{
+    std::lock_guard<std::mutex> lock(errorMutex);
+
+    if (errorReported)
+        return false;
+
+    errorReported = true;
+    return true;
+}
+
 void Console::compileErrorOnToken(const std::string& message, const Token& tok)
 {
-    pp::errorOnToken(tok.getFileName(), message, streamsMap[tok.getFileName()], tok);
+    if (!claimErrorOutput())
+        throw CompileError();
+
+    pp::errorOnToken(tok.getFileName(), message, getTokenSource(tok), tok);
     printModuleStackLine(tok.getLineNo(), tok.getColumn());
     throw CompileError();
 }
 
 void Console::typeError(const Token& tok, const Unit& expected, const Unit& found)
 {
+    if (!claimErrorOutput())
+        throw CompileError();
+
     pp::typeError(fileName, *file, tok, expected.type(), found.type());
     printModuleStackLine(tok.getLineNo(), tok.getColumn());
     throw CompileError();
@@ -37,6 +67,9 @@ void Console::typeError(const Token& tok, const Unit& expected, const Unit& foun
 
 void Console::operatorError(const Token& tok, const Unit& expected, const Unit& found)
 {
+    if (!claimErrorOutput())
+        throw CompileError();
+
     pp::operatorError(fileName, *file, tok, expected.type(), found.type());
     printModuleStackLine(tok.getLineNo(), tok.getColumn());
     throw CompileError();
@@ -44,6 +77,9 @@ void Console::operatorError(const Token& tok, const Unit& expected, const Unit&
 
 void Console::internalBugErrorOnToken(const Token& tok)
 {
+    if (!claimErrorOutput())
+        throw InternalBugError();
+
     pp::errorOnToken(fileName, "Internal compiler error, REPORT THIS BUG", *file, tok);
     printModuleStackLine(tok.getLineNo(), tok.getColumn());
     throw InternalBugError();
@@ -51,6 +87,9 @@ void Console::internalBugErrorOnToken(const Token& tok)
 
 void Console::internalBugError()
 {
+    if (!claimErrorOutput())
+        throw InternalBugError();
+
     pp::errorOnModuleName(fileName, "Internal compiler error, REPORT THIS BUG");
     printModuleStack();
     throw InternalBugError();
@@ -58,6 +97,9 @@ void Console::internalBugError()
 
 void Console::internalBugErrorMessage(const std::string& message)
 {
+    if (!claimErrorOutput())
+        throw InternalBugError();
+
     pp::println(message);
     printModuleStack();
     throw InternalBugError();
@@ -65,6 +107,9 @@ void Console::internalBugErrorMessage(const std::string& message)
 
 void Console::parseError(token::TokenType& expected, Token& found)
 {
+    if (!claimErrorOutput())
+        throw CompileError();
+
     pp::parserError(fileName, expected, found, *file);
     printModuleStackLine(found.getLineNo(), found.getColumn());
     throw CompileError();
@@ -72,6 +117,9 @@ void Console::parseError(token::TokenType& expected, Token& found)
 
 void Console::parserErrorMultiple(const token::TokenType* expected, int ntoks, const Token& found)
 {
+    if (!claimErrorOutput())
+        throw CompileError();
+
     pp::parserErrorMultiple(fileName, expected, ntoks, found, *file);
     printModuleStackLine(found.getLineNo(), found.getColumn());
     throw CompileError();
@@ -79,6 +127,9 @@ void Console::parserErrorMultiple(const token::TokenType* expected, int ntoks, c
 
 void Console::lexerError(const std::string& errorMessage, const std::string& line, int lineno, int col)
 {
+    if (!claimErrorOutput())
+        throw CompileError();
+
     pp::errorOnLine(fileName, errorMessage, line, lineno, col);
     printModuleStackLine(lineno, col);
     throw CompileError();
@@ -90,9 +141,14 @@ void Console::check(bool flag)
         internalBugError();
 }
 
-std::ifstream* Console::getStream()
+const source::SourceFile& Console::getSource()
+{
+    return *file;
+}
+
+std::shared_ptr<const source::SourceFile> Console::getSharedSource()
 {
-    return file;
+    return sourcesMap.at(fileName);
 }
 
 std::string Console::getFileName()
@@ -102,17 +158,14 @@ std::string Console::getFileName()
 
 void Console::pushRootModule(const std::string& path)
 {
-    if (!keyExistsInMap(streamsMap, path))
-    {
-        streamsMap[path].exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        streamsMap[path].open(path);
-    }
+    if (!keyExistsInMap(sourcesMap, path))
+        sourcesMap[path] = source::loadFile(path);
 
     fileName = path;
-    file = &streamsMap[path];
+    file = sourcesMap[path].get();
 
     fileNameStack.push_back(path);
-    fileStack.push_back(&streamsMap[path]);
+    fileStack.push_back(file);
 }
 
 bool invalidModuleName(const std::string& path)
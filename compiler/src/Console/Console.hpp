@@ -1,12 +1,14 @@
 #ifndef CONSOLE_CONSOLE
 #define CONSOLE_CONSOLE
 
-#include <fstream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "../Builder/Unit.hpp"
 #include "../PrettyPrint/Errors.hpp"
+#include "../Source/SourceManager.hpp"
 
 struct CompileError
 {
@@ -19,11 +21,20 @@ struct InternalBugError
 class Console
 {
     std::string fileName;
-    std::ifstream* file;
+    const source::SourceFile* file;
 
-    std::map<std::string, std::ifstream> streamsMap;
+    std::map<std::string, std::shared_ptr<const source::SourceFile>> sourcesMap;
     std::vector<std::string> fileNameStack;
-    std::vector<std::ifstream*> fileStack;
+    std::vector<const source::SourceFile*> fileStack;
+
+    std::mutex errorMutex;
+    bool errorReported = false;
+
+    const source::SourceFile& getTokenSource(const Token& tok);
+
+    /* Functions and modules can be generated on many threads, only the first error is printed,
+        threads failing after it just throw */
+    bool claimErrorOutput();
 
     void printModuleStackLine(int lineNo, int colNo);
     void printModuleStack();
@@ -49,7 +60,10 @@ public:
 
     void check(bool flag);
 
-    std::ifstream* getStream();
+    const source::SourceFile& getSource();
+
+    /* For keeping the current file mapped after the compile, when its tokens are kept */
+    std::shared_ptr<const source::SourceFile> getSharedSource();
 
     std::string getFileName();
 
@@ -205,7 +205,7 @@ Unit coerceStringTypes(generator::GeneratorContext& ctx,
     if (actualParam.isSingleDimCharArray() && formalParam.isStruct() &&
         ctx.ir.finder.functionExists(formalParam.type(), coerceArrayHook))
     {
-        const FunctionDescription stringFunc = ctx.ir.finder.getMethod(formalParam.type(), coerceArrayHook);
+        const FunctionDescription& stringFunc = ctx.ir.finder.getMethod(formalParam.type(), coerceArrayHook);
         const Unit lengthParam = ctx.ir.unitBuilder.unitFromIntLiteral(actualParam.numElements());
         return createCallFunction(ctx, { token, token }, { actualParam, lengthParam }, stringFunc, token);
     }
@@ -278,7 +278,7 @@ Unit methodCall(generator::GeneratorContext& ctx, const Node& root)
         if (!ctx.ir.finder.deconstructorExists(firstActualParam.type()))
             return firstActualParam;
 
-    const FunctionDescription callee = ctx.ir.finder.getFunction(calleeNameToken);
+    const FunctionDescription& callee = ctx.ir.finder.getFunction(calleeNameToken);
     const std::vector<Unit> formalParameters = ctx.ir.finder.getFormalParameters(callee);
 
     ctx.ir.resetWorkingModule();
@@ -305,7 +305,7 @@ Unit functionCall(generator::GeneratorContext& ctx, const Node& root)
 
     const Token calleeNameToken = root.tok;
 
-    FunctionDescription callee = ctx.ir.finder.getFunction(calleeNameToken);
+    const FunctionDescription& callee = ctx.ir.finder.getFunction(calleeNameToken);
     std::vector<Unit> formalParameters = ctx.ir.finder.getFormalParameters(callee);
 
     ctx.ir.resetWorkingModule();
@@ -332,13 +332,16 @@ Unit genericFunctionCall(generator::GeneratorContext& ctx, const Node& root)
 
     size_t nodeCounter;
 
-    for (nodeCounter = 0; root.children[nodeCounter].type == node::GENERIC_TYPE_PARAM; nodeCounter += 1)
+    for (nodeCounter = 0; nodeCounter < root.children.size(); nodeCounter += 1)
     {
+        if (root.children[nodeCounter].type != node::GENERIC_TYPE_PARAM)
+            break;
+
         instantiationTypeNodes.push_back(root.children[nodeCounter]);
         instantiationTypes.push_back(typeDescriptionFromNode(ctx, root.children[nodeCounter]));
     }
 
-    const FunctionDescription callee = instantiateGenericAndGetFunction(ctx,
+    const FunctionDescription& callee = instantiateGenericAndGetFunction(ctx,
                                                                         genericModuleName,
                                                                         calleeNameToken,
                                                                         instantiationTypes,
@@ -388,7 +391,7 @@ Unit createMake(generator::GeneratorContext& ctx,
 
     ctx.ir.setWorkingModule(ctx.ir.finder.getModuleFromType(type));
 
-    FunctionDescription constructor = ctx.ir.finder.getFunctionByParamTypes(errorToken, type, actualParams);
+    const FunctionDescription& constructor = ctx.ir.finder.getFunctionByParamTypes(errorToken, type, actualParams);
 
     ctx.ir.popWorkingModule();
 
@@ -442,7 +445,8 @@ Unit createOperatorFunctionCall(generator::GeneratorContext& ctx,
         params.push_back(ctx.ir.unitBuilder.unitFromIntLiteral(RHS.numElements()));
     }
 
-    FunctionDescription callee = ctx.ir.finder.getCustomOperatorFunction(customOperatorName, params, errorToken);
+    const FunctionDescription& callee =
+        ctx.ir.finder.getCustomOperatorFunction(customOperatorName, params, errorToken);
 
     ctx.ir.popWorkingModule();
 
@@ -482,8 +486,10 @@ Unit multilineStringLiteral(generator::GeneratorContext& ctx, const Node& root)
     for (const Node& child : root.children)
         stringTokens.push_back(child.tok);
 
-    const std::string key = ctx.ir.moduleBuilder.createMultilineStringData(stringTokens);
-    return ctx.ir.unitBuilder.unitFromStringDataKey(key);
+    int charCount;
+    const std::string key = ctx.ir.moduleBuilder.createMultilineStringData(stringTokens, charCount);
+
+    return ctx.ir.unitBuilder.unitFromStringData(key, charCount);
 }
 
 Unit initializerList(generator::GeneratorContext& ctx, const Node& root, const TypeDescription& typeHint)
@@ -658,7 +664,7 @@ void truthyOperator(generator::GeneratorContext& ctx,
 
     if (LHS.isStruct())
     {
-        const icode::FunctionDescription isNonZeroFunc =
+        const icode::FunctionDescription& isNonZeroFunc =
             ctx.ir.finder.getMethodFromUnit(LHS, isNonZeroHook, expressionToken);
 
         const Unit isNonZeroFuncRetVal =
@@ -709,7 +715,7 @@ Unit questionMarkOperator(generator::GeneratorContext& ctx, const Node& root)
 {
     const Unit term = expression(ctx, root.children[0]);
     const Token expressionToken = root.children[0].tok;
-    const TypeDescription returnType = ctx.ir.functionBuilder.getReturnValueUnit().type();
+    const TypeDescription& returnType = ctx.ir.functionBuilder.getReturnValueUnit().type();
 
     const std::string continueHook = "__questionMarkContinue__";
     const std::string unwrapHook = "__questionMarkUnwrap__";
@@ -721,10 +727,10 @@ Unit questionMarkOperator(generator::GeneratorContext& ctx, const Node& root)
                                             " function for return type",
                                         root.tok);
 
-    const FunctionDescription continueFunc = ctx.ir.finder.getMethodFromUnit(term, continueHook, root.tok);
-    const FunctionDescription errorFunc = ctx.ir.finder.getMethodFromUnit(term, errorHook, root.tok);
-    const FunctionDescription constructorFunc = ctx.ir.finder.getMethod(returnType, constructorHook);
-    const FunctionDescription unwrapFunc = ctx.ir.finder.getMethodFromUnit(term, unwrapHook, root.tok);
+    const FunctionDescription& continueFunc = ctx.ir.finder.getMethodFromUnit(term, continueHook, root.tok);
+    const FunctionDescription& errorFunc = ctx.ir.finder.getMethodFromUnit(term, errorHook, root.tok);
+    const FunctionDescription& constructorFunc = ctx.ir.finder.getMethod(returnType, constructorHook);
+    const FunctionDescription& unwrapFunc = ctx.ir.finder.getMethodFromUnit(term, unwrapHook, root.tok);
 
     const icode::Operand falseLabel = ctx.ir.functionBuilder.createLabel(root.tok, false, "question_op");
     const icode::Operand trueLabel = ctx.ir.functionBuilder.createLabel(root.tok, true, "question_op");
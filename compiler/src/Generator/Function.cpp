@@ -47,4 +47,16 @@ void createFunctionFromNode(generator::GeneratorContext& ctx, const Node& root)
     }
     else
         ctx.ir.moduleBuilder.createExternFunction(nameToken, returnType, paramNames, paramTypes);
+}
+
+void putParametersInScope(generator::GeneratorContext& ctx, const Node& root)
+{
+    /* Local variables of functions generated before this one could have the same names as the parameters */
+    for (size_t i = 1; i < root.children.size(); i += 1)
+    {
+        if (!root.children[i].isParamNode())
+            break;
+
+        ctx.scope.putInCurrentScope(root.children[i].getNthChildToken(0));
+    }
 }
\ No newline at end of file
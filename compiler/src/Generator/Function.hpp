@@ -5,4 +5,6 @@
 
 void createFunctionFromNode(generator::GeneratorContext& ctx, const Node& root);
 
+void putParametersInScope(generator::GeneratorContext& ctx, const Node& root);
+
 #endif
\ No newline at end of file
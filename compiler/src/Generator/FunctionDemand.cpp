@@ -0,0 +1,242 @@
+#include <set>
+#include <utility>
+
+#include "../Builder/NameMangle.hpp"
+#include "../Utils/PhaseTimer.hpp"
+#include "GeneratorContext.hpp"
+
+#include "FunctionDemand.hpp"
+
+void generateFunction(generator::GeneratorContext& ctx, const Node& child);
+
+std::string getFunctionName(generator::GeneratorContext& ctx, const Node& child);
+
+namespace generator
+{
+    bool isInstantiatedModule(const std::string& moduleName)
+    {
+        return moduleName.find('[') != std::string::npos;
+    }
+
+    bool isNameMangled(const std::string& functionName, const std::string& moduleName)
+    {
+        const std::string manglePrefix = nameMangleString("", moduleName);
+        return functionName.compare(0, manglePrefix.size(), manglePrefix) == 0;
+    }
+
+    /* Functions are held by symbol id, so the walk looks up a called function by the id in the call entry */
+    void demandFunction(const icode::StringModulesMap& modulesMap,
+                        const std::string& moduleName,
+                        icode::SymbolId functionName,
+                        std::set<ModuleFunctionPair>& demandedFunctions,
+                        std::vector<ModuleFunctionPair>& pendingFunctions)
+    {
+        auto modulePair = modulesMap.find(moduleName);
+
+        if (modulePair == modulesMap.end() || modulePair->second.functions.count(functionName) == 0)
+            return;
+
+        if (demandedFunctions.insert({ moduleName, functionName }).second)
+            pendingFunctions.push_back({ moduleName, functionName });
+    }
+
+    void demandCallees(const icode::StringModulesMap& modulesMap,
+                       const ModuleFunctionPair& demandedFunction,
+                       std::set<ModuleFunctionPair>& demandedFunctions,
+                       std::vector<ModuleFunctionPair>& pendingFunctions)
+    {
+        const icode::FunctionDescription& function =
+            modulesMap.at(demandedFunction.first).functions.at(demandedFunction.second);
+
+        for (const icode::Entry& entry : function.icodeTable)
+            if (entry.opcode == icode::CALL)
+                demandFunction(modulesMap,
+                               icode::symbolName(entry.op3.name),
+                               entry.op2.name,
+                               demandedFunctions,
+                               pendingFunctions);
+    }
+
+    void eraseUndemandedFunctions(icode::ModuleDescription& module,
+                                  const std::set<ModuleFunctionPair>& demandedFunctions)
+    {
+        std::vector<std::string> definedFunctions;
+
+        for (const std::string& functionName : module.definedFunctions)
+        {
+            if (demandedFunctions.count({ module.name, icode::internSymbol(functionName) }) != 0)
+                definedFunctions.push_back(functionName);
+            else
+                module.functions.erase(functionName);
+        }
+
+        module.definedFunctions = definedFunctions;
+    }
+
+    FunctionDemand::~FunctionDemand() {}
+
+    void FunctionDemand::setRootModule(const std::string& moduleName)
+    {
+        rootModule = moduleName;
+    }
+
+    void FunctionDemand::demandFunction(const icode::StringModulesMap& modulesMap,
+                                        const std::string& moduleName,
+                                        icode::SymbolId functionName)
+    {
+        generator::demandFunction(modulesMap, moduleName, functionName, demandedFunctions, pendingFunctions);
+    }
+
+    DeferredModule& FunctionDemand::deferModule(GeneratorContext& ctx, const std::string& moduleName, AST ast)
+    {
+        DeferredModule& deferredModule = deferredModules[moduleName];
+
+        deferredModule.ast = ast;
+        deferredModule.rootModule = rootModule;
+        deferredModule.firstId = 0;
+        deferredModule.fileName = ctx.console.getFileName();
+        deferredModule.ctx = std::make_unique<GeneratorContext>(ctx.modulesMap,
+                                                                ctx.genericsMap,
+                                                                ctx.instantiationMemo,
+                                                                ctx.irCache,
+                                                                moduleName,
+                                                                ctx.console,
+                                                                ctx.functionDemand,
+                                                                ctx.functionJobs);
+
+        for (const Node& child : deferredModule.ast.getRoot().children)
+        {
+            if (child.type != node::FUNCTION && child.type != node::FUNCTION_EXTERN_C)
+                continue;
+
+            const std::string functionName = getFunctionName(*deferredModule.ctx, child);
+            deferredModule.functionNodes[icode::internSymbol(functionName)] = &child;
+        }
+
+        return deferredModule;
+    }
+
+    bool FunctionDemand::seedModules(const icode::StringModulesMap& modulesMap)
+    {
+        /* Every function of a module that is not instantiated is generated, and so are extern C functions,
+            they can be called from outside the program */
+
+        bool seeded = false;
+
+        for (const auto& modulePair : modulesMap)
+        {
+            if (!seededModules.insert(modulePair.first).second)
+                continue;
+
+            seeded = true;
+
+            const bool isInstantiated = isInstantiatedModule(modulePair.first);
+
+            for (const auto& functionPair : modulePair.second.functions)
+                if (!isInstantiated || !isNameMangled(functionPair.first, modulePair.first))
+                    demandFunction(modulesMap, modulePair.first, icode::internSymbol(functionPair.first));
+        }
+
+        return seeded;
+    }
+
+    bool FunctionDemand::generateDeferredFunction(const std::string& moduleName, icode::SymbolId functionName)
+    {
+        auto deferredModule = deferredModules.find(moduleName);
+
+        if (deferredModule == deferredModules.end())
+            return false;
+
+        auto functionNode = deferredModule->second.functionNodes.find(functionName);
+
+        if (functionNode == deferredModule->second.functionNodes.end())
+            return false;
+
+        GeneratorContext& ctx = *deferredModule->second.ctx;
+
+        timer::ScopedPhase phase("Function generation", moduleName);
+
+        /* Modules instantiated by this function are reported under the same root module */
+        setRootModule(deferredModule->second.rootModule);
+
+        ctx.ir.opBuilder.setIdCounter(deferredModule->second.firstId);
+
+        ctx.console.pushRootModule(rootModule);
+        ctx.console.pushRootModule(deferredModule->second.fileName);
+        generateFunction(ctx, *functionNode->second);
+        ctx.console.popModule();
+        ctx.console.popModule();
+
+        return true;
+    }
+
+    bool FunctionDemand::generateDemandedFunctions(icode::StringModulesMap& modulesMap)
+    {
+        /* Generating a body can instantiate and use more modules, they are seeded once the pending
+            functions run out */
+
+        while (seedModules(modulesMap))
+        {
+            while (pendingFunctions.size() != 0)
+            {
+                const ModuleFunctionPair demandedFunction = pendingFunctions.back();
+                pendingFunctions.pop_back();
+
+                /* A generated function always ends with a return, an empty body was never generated */
+                const bool generated =
+                    modulesMap.at(demandedFunction.first).functions.at(demandedFunction.second).icodeTable.size() != 0;
+
+                if (!generated && !generateDeferredFunction(demandedFunction.first, demandedFunction.second))
+                    return false;
+
+                demandCallees(modulesMap, demandedFunction, demandedFunctions, pendingFunctions);
+            }
+        }
+
+        return true;
+    }
+
+    void FunctionDemand::removeUndemandedFunctions(icode::StringModulesMap& modulesMap)
+    {
+        for (auto& modulePair : modulesMap)
+            if (isInstantiatedModule(modulePair.first))
+                eraseUndemandedFunctions(modulePair.second, demandedFunctions);
+    }
+
+    void removeUndemandedFunctions(icode::StringModulesMap& modulesMap, const std::vector<std::string>& rootModules)
+    {
+        std::set<ModuleFunctionPair> demandedFunctions;
+        std::vector<ModuleFunctionPair> pendingFunctions;
+
+        const std::set<std::string> rootModuleSet(rootModules.begin(), rootModules.end());
+
+        for (const auto& modulePair : modulesMap)
+        {
+            const bool isRoot = rootModuleSet.count(modulePair.first) != 0;
+
+            /* Extern C functions are not name mangled, they can be called from outside the program */
+            for (const auto& functionPair : modulePair.second.functions)
+            {
+                if (!isRoot && isNameMangled(functionPair.first, modulePair.first))
+                    continue;
+
+                demandFunction(modulesMap,
+                               modulePair.first,
+                               icode::internSymbol(functionPair.first),
+                               demandedFunctions,
+                               pendingFunctions);
+            }
+        }
+
+        while (pendingFunctions.size() != 0)
+        {
+            const ModuleFunctionPair demandedFunction = pendingFunctions.back();
+            pendingFunctions.pop_back();
+
+            demandCallees(modulesMap, demandedFunction, demandedFunctions, pendingFunctions);
+        }
+
+        for (auto& modulePair : modulesMap)
+            eraseUndemandedFunctions(modulePair.second, demandedFunctions);
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef GENERATOR_FUNCTION_DEMAND
+#define GENERATOR_FUNCTION_DEMAND
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../IntermediateRepresentation/All.hpp"
+#include "../Node/AST.hpp"
+
+namespace generator
+{
+    struct GeneratorContext;
+
+    typedef std::pair<std::string, icode::SymbolId> ModuleFunctionPair;
+
+    struct DeferredModule
+    {
+        AST ast;
+        std::string rootModule;
+        std::string fileName;
+        std::unique_ptr<GeneratorContext> ctx;
+        std::map<icode::SymbolId, const Node*> functionNodes;
+
+        /* Bodies are generated in the order they are demanded, each one numbers its operands from the id
+            after the symbols so the IR does not depend on that order. Ids are only unique within a function */
+        unsigned int firstId;
+    };
+
+    /* Whether a generic module compiles already depends on its type arguments, so the function bodies of
+        instantiated modules are generated only once a generated function calls them, for every output
+        option. Their symbols are generated when they are instantiated. Other modules are always generated
+        in full, so their errors do not depend on the output option */
+    class FunctionDemand
+    {
+        std::map<std::string, DeferredModule> deferredModules;
+        std::string rootModule;
+
+        std::set<std::string> seededModules;
+        std::set<ModuleFunctionPair> demandedFunctions;
+        std::vector<ModuleFunctionPair> pendingFunctions;
+
+        void demandFunction(const icode::StringModulesMap& modulesMap,
+                            const std::string& moduleName,
+                            icode::SymbolId functionName);
+
+        bool seedModules(const icode::StringModulesMap& modulesMap);
+
+        bool generateDeferredFunction(const std::string& moduleName, icode::SymbolId functionName);
+
+    public:
+        ~FunctionDemand();
+
+        /* Errors in a deferred function are reported under the root module that instantiated its module */
+        void setRootModule(const std::string& moduleName);
+
+        DeferredModule& deferModule(GeneratorContext& ctx, const std::string& moduleName, AST ast);
+
+        /* Returns false if a module loaded from the IR cache lacks the body of a called function,
+            the body was not demanded by the compile that stored it */
+        bool generateDemandedFunctions(icode::StringModulesMap& modulesMap);
+
+        /* Removes the functions of instantiated modules that were not demanded, including bodies loaded from
+            the IR cache, so the IR does not depend on what earlier compiles demanded */
+        void removeUndemandedFunctions(icode::StringModulesMap& modulesMap);
+    };
+
+    /* Functions of used modules are translated only when they are reachable from a root module, through
+        calls from reachable functions, or when they are extern C functions. The rest are removed from the
+        modules map so they are not translated */
+    void removeUndemandedFunctions(icode::StringModulesMap& modulesMap, const std::vector<std::string>& rootModules);
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <vector>
+
+#include "FunctionJobs.hpp"
+
+namespace generator
+{
+    static thread_local bool isWorker = false;
+    static thread_local unsigned int exclusiveDepth = 0;
+
+    FunctionJobs::FunctionJobs(unsigned int jobs)
+        : jobs(jobs)
+    {
+    }
+
+    unsigned int FunctionJobs::getJobs() const
+    {
+        return jobs;
+    }
+
+    bool FunctionJobs::canRunInParallel(size_t functionCount) const
+    {
+        return jobs > 1 && functionCount > 1 && !isWorker;
+    }
+
+    void FunctionJobs::run(size_t functionCount, const std::function<void(unsigned int, size_t)>& generate)
+    {
+        std::atomic<size_t> nextFunctionIndex(0);
+        std::atomic<bool> failed(false);
+
+        auto worker = [&](unsigned int workerIndex)
+        {
+            isWorker = true;
+
+            try
+            {
+                for (size_t i = nextFunctionIndex++; i < functionCount && !failed; i = nextFunctionIndex++)
+                {
+                    std::shared_lock<std::shared_mutex> lock(mutex);
+                    generate(workerIndex, i);
+                }
+            }
+            catch (...)
+            {
+                isWorker = false;
+                failed = true;
+                throw;
+            }
+
+            isWorker = false;
+        };
+
+        std::vector<std::future<void>> workers;
+
+        for (unsigned int i = 0; i < std::min<size_t>(jobs, functionCount); i += 1)
+            workers.push_back(std::async(std::launch::async, worker, i));
+
+        /* Wait for all workers before rethrowing the first error, if any */
+        for (std::future<void>& workerFuture : workers)
+            workerFuture.wait();
+
+        for (std::future<void>& workerFuture : workers)
+            workerFuture.get();
+    }
+
+    ExclusiveSection::ExclusiveSection(FunctionJobs& functionJobs)
+        : functionJobs(functionJobs)
+    {
+        if (!isWorker)
+            return;
+
+        /* Sections nest when instantiating a generic instantiates another one */
+        if (exclusiveDepth++ == 0)
+        {
+            functionJobs.mutex.unlock_shared();
+            functionJobs.mutex.lock();
+        }
+    }
+
+    ExclusiveSection::~ExclusiveSection()
+    {
+        if (!isWorker)
+            return;
+
+        if (--exclusiveDepth == 0)
+        {
+            functionJobs.mutex.unlock();
+            functionJobs.mutex.lock_shared();
+        }
+    }
+}
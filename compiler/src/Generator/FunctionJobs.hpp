@@ -0,0 +1,44 @@
+#ifndef GENERATOR_FUNCTION_JOBS
+#define GENERATOR_FUNCTION_JOBS
+
+#include <functional>
+#include <shared_mutex>
+
+namespace generator
+{
+    /* Function bodies of a module are generated by worker threads when there is more than one job.
+        A worker holds the lock shared while it generates a function, and exclusively while it changes
+        state the other workers read, like instantiating a generic module */
+    class FunctionJobs
+    {
+        unsigned int jobs;
+        std::shared_mutex mutex;
+
+        friend class ExclusiveSection;
+
+    public:
+        FunctionJobs(unsigned int jobs);
+
+        unsigned int getJobs() const;
+
+        /* Modules generated from a worker thread, while instantiating a generic for example,
+            have their functions generated serially on that thread */
+        bool canRunInParallel(size_t functionCount) const;
+
+        /* Calls generate(workerIndex, functionIndex) for every function from the worker threads. The
+            functions left are skipped after an error, which is rethrown once all workers are done */
+        void run(size_t functionCount, const std::function<void(unsigned int, size_t)>& generate);
+    };
+
+    /* Lets a worker change shared state, does nothing outside worker threads */
+    class ExclusiveSection
+    {
+        FunctionJobs& functionJobs;
+
+    public:
+        ExclusiveSection(FunctionJobs& functionJobs);
+        ~ExclusiveSection();
+    };
+}
+
+#endif
@@ -6,20 +6,36 @@ namespace generator
 {
     GeneratorContext::GeneratorContext(icode::StringModulesMap& modulesMap,
                                        monomorphizer::StringGenericASTMap& genericsMap,
+                                       monomorphizer::InstantiationMemo& instantiationMemo,
+                                       IRCache& irCache,
                                        const std::string& fileName,
-                                       Console& console)
+                                       Console& console,
+                                       FunctionDemand& functionDemand,
+                                       FunctionJobs& functionJobs)
 
         : ir(modulesMap, fileName, console)
         , mm(genericsMap, console)
         , console(console)
+        , moduleName(fileName)
         , modulesMap(modulesMap)
         , genericsMap(genericsMap)
+        , instantiationMemo(instantiationMemo)
+        , irCache(irCache)
+        , functionDemand(functionDemand)
+        , functionJobs(functionJobs)
     {
     }
 
     GeneratorContext GeneratorContext::clone(const std::string& fileName)
     {
-        return GeneratorContext(modulesMap, genericsMap, fileName, console);
+        return GeneratorContext(modulesMap,
+                                genericsMap,
+                                instantiationMemo,
+                                irCache,
+                                fileName,
+                                console,
+                                functionDemand,
+                                functionJobs);
     }
 
     bool GeneratorContext::moduleExists(const std::string& name)
@@ -2,6 +2,9 @@
 #define GENERATOR_GENERATOR_CONTEXT
 
 #include "../Builder/IRBuilder.hpp"
+#include "../IRSerializer/IRCache.hpp"
+#include "FunctionDemand.hpp"
+#include "FunctionJobs.hpp"
 #include "Monomorphizer/Monomorphizer.hpp"
 #include "ScopeTracker.hpp"
 
@@ -14,13 +17,22 @@ namespace generator
         ScopeTracker scope;
         Console& console;
 
+        std::string moduleName;
         icode::StringModulesMap& modulesMap;
         monomorphizer::StringGenericASTMap& genericsMap;
+        monomorphizer::InstantiationMemo& instantiationMemo;
+        IRCache& irCache;
+        FunctionDemand& functionDemand;
+        FunctionJobs& functionJobs;
 
         GeneratorContext(icode::StringModulesMap& modulesMap,
                          monomorphizer::StringGenericASTMap& genericsMap,
+                         monomorphizer::InstantiationMemo& instantiationMemo,
+                         IRCache& irCache,
                          const std::string& fileName,
-                         Console& console);
+                         Console& console,
+                         FunctionDemand& functionDemand,
+                         FunctionJobs& functionJobs);
 
         GeneratorContext clone(const std::string& fileName);
 
@@ -1,10 +1,12 @@
 #include "../Builder/NameMangle.hpp"
+#include "../Utils/MemoryReport.hpp"
+#include "../Utils/PhaseTimer.hpp"
 
 #include "Generic.hpp"
 
 using namespace icode;
 
-void generateModule(generator::GeneratorContext& ctx, const Node& root);
+void generateInstantiatedModule(generator::GeneratorContext& ctx, const std::string& moduleName, const AST& ast);
 
 std::string typeDescriptionToString(const icode::TypeDescription& typeDescription)
 {
@@ -37,29 +39,63 @@ std::string constructInstantiationSuffix(const std::vector<icode::TypeDescriptio
     return result;
 }
 
+AST instantiateGenericAST(generator::GeneratorContext& ctx,
+                          const std::string& instantiatedModuleName,
+                          const std::string& genericModuleName,
+                          const Token& genericNameToken,
+                          const std::vector<TypeDescription>& instantiationTypes,
+                          const std::vector<Node>& instantiationTypeNodes)
+{
+    AST ast;
+
+    {
+        timer::ScopedPhase phase("Monomorphization", instantiatedModuleName);
+        ast = ctx.mm.instantiateGeneric(genericModuleName, genericNameToken, instantiationTypes, instantiationTypeNodes);
+    }
+
+    memory::recordAST(instantiatedModuleName, ast);
+    return ast;
+}
+
 std::string generateIRUsingMonomorphizer(generator::GeneratorContext& ctx,
                                          const std::string& genericModuleName,
                                          const Token& genericNameToken,
                                          const std::vector<TypeDescription>& instantiationTypes,
                                          const std::vector<Node>& instantiationTypeNodes)
 {
-    const std::string instantiationSuffix = constructInstantiationSuffix(instantiationTypes);
+    std::string instantiatedModuleName;
+
+    if (ctx.instantiationMemo.getInstantiatedModule(genericModuleName, instantiationTypes, instantiatedModuleName))
+        return instantiatedModuleName;
+
+    /* Another worker could instantiate the same module before this one gets the lock,
+        the module is then found in the modules map */
+    generator::ExclusiveSection section(ctx.functionJobs);
 
-    const std::string instantiatedModuleName = genericModuleName + instantiationSuffix;
+    instantiatedModuleName = genericModuleName + constructInstantiationSuffix(instantiationTypes);
 
-    if (!ctx.moduleExists(instantiatedModuleName))
+    if (!ctx.moduleExists(instantiatedModuleName) && !ctx.irCache.loadModules(instantiatedModuleName, ctx.modulesMap))
     {
         ctx.console.pushModuleString(genericModuleName, genericNameToken);
 
-        Node ast =
-            ctx.mm.instantiateGeneric(genericModuleName, genericNameToken, instantiationTypes, instantiationTypeNodes);
+        const AST ast = instantiateGenericAST(ctx,
+                                              instantiatedModuleName,
+                                              genericModuleName,
+                                              genericNameToken,
+                                              instantiationTypes,
+                                              instantiationTypeNodes);
 
-        generator::GeneratorContext generatorContext = ctx.clone(instantiatedModuleName);
-        generateModule(generatorContext, ast);
+        ctx.irCache.beginModule(instantiatedModuleName);
+
+        generateInstantiatedModule(ctx, instantiatedModuleName, ast);
+
+        ctx.irCache.endModule(instantiatedModuleName);
 
         ctx.console.popModule();
     }
 
+    ctx.instantiationMemo.addInstantiatedModule(genericModuleName, instantiationTypes, instantiatedModuleName);
+
     return instantiatedModuleName;
 }
 
@@ -86,11 +122,11 @@ TypeDescription instantiateGenericAndGetType(generator::GeneratorContext& ctx,
     return monomorphizedType;
 }
 
-FunctionDescription instantiateGenericAndGetFunction(generator::GeneratorContext& ctx,
-                                                     const std::string& genericModuleName,
-                                                     const Token& genericFunctionNameToken,
-                                                     const std::vector<TypeDescription>& instantiationTypes,
-                                                     const std::vector<Node>& instantiationTypeNodes)
+const FunctionDescription& instantiateGenericAndGetFunction(generator::GeneratorContext& ctx,
+                                                            const std::string& genericModuleName,
+                                                            const Token& genericFunctionNameToken,
+                                                            const std::vector<TypeDescription>& instantiationTypes,
+                                                            const std::vector<Node>& instantiationTypeNodes)
 {
     ctx.ir.pushWorkingModule();
 
@@ -102,7 +138,7 @@ FunctionDescription instantiateGenericAndGetFunction(generator::GeneratorContext
 
     ctx.ir.setWorkingModule(&ctx.modulesMap.at(moduleName));
 
-    FunctionDescription monomorphizedFunction = ctx.ir.finder.getFunction(genericFunctionNameToken);
+    const FunctionDescription& monomorphizedFunction = ctx.ir.finder.getFunction(genericFunctionNameToken);
 
     ctx.ir.popWorkingModule();
 
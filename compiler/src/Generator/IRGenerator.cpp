@@ -8,17 +8,30 @@
 
 #include "IRGenerator.hpp"
 
+#include "../Builder/NameMangle.hpp"
 #include "../Lexer/Lexer.hpp"
 #include "../Parser/Parser.hpp"
+#include "../Utils/KeyExistsInMap.hpp"
+#include "../Utils/MemoryReport.hpp"
+#include "../Utils/PhaseTimer.hpp"
 
 #include "IRGenerator.hpp"
 
 using namespace icode;
 
-Node generator::generateAST(Console& console)
+AST generator::generateAST(Console& console)
 {
     lexer::Lexer lex(console);
-    return parser::generateAST(lex, console);
+
+    AST ast;
+
+    {
+        timer::ScopedPhase phase("Parsing", console.getFileName());
+        ast = parser::generateAST(lex, console);
+    }
+
+    memory::recordAST(console.getFileName(), ast);
+    return ast;
 }
 
 void generateIncompleteType(generator::GeneratorContext& ctx, const Node& child)
@@ -71,13 +84,12 @@ void generateSymbol(generator::GeneratorContext& ctx, const Node& child)
     }
 }
 
-void generateFunction(generator::GeneratorContext& ctx, const Node& child)
+void generateFunctionBody(generator::GeneratorContext& ctx, const Node& child)
 {
     const Token functionNameToken = child.children[0].tok;
 
-    ctx.ir.setWorkingFunction(functionNameToken, child.type == node::FUNCTION_EXTERN_C);
-
     ctx.scope.resetScope();
+    putParametersInScope(ctx, child);
 
     block(ctx,
           child.children.back(),
@@ -89,30 +101,272 @@ void generateFunction(generator::GeneratorContext& ctx, const Node& child)
     ctx.ir.functionBuilder.terminateFunction(functionNameToken);
 }
 
-void generateModule(generator::GeneratorContext& ctx, const Node& root)
+void generateFunction(generator::GeneratorContext& ctx, const Node& child)
+{
+    ctx.ir.setWorkingFunction(child.children[0].tok, child.type == node::FUNCTION_EXTERN_C);
+    generateFunctionBody(ctx, child);
+}
+
+std::string getFunctionName(generator::GeneratorContext& ctx, const Node& child)
+{
+    if (child.type == node::FUNCTION_EXTERN_C)
+        return child.children[0].tok.toString();
+
+    return nameMangle(child.children[0].tok, ctx.moduleName);
+}
+
+void moveOperandIds(icode::FunctionDescription& function, unsigned int workerFirstId, unsigned int firstId)
+{
+    for (icode::Entry& entry : function.icodeTable)
+        for (icode::Operand* op : { &entry.op1, &entry.op2, &entry.op3 })
+            if (op->operandId >= workerFirstId)
+                op->operandId = op->operandId - workerFirstId + firstId;
+}
+
+void resolveStringData(generator::GeneratorContext& ctx,
+                       icode::FunctionDescription& function,
+                       const std::vector<std::pair<std::string, std::string>>& stringData)
+{
+    std::map<icode::SymbolId, icode::SymbolId> renamedKeys;
+
+    for (const auto& keyStringPair : stringData)
+    {
+        const std::string key = ctx.ir.moduleBuilder.resolveDeferredStringData(keyStringPair.first,
+                                                                                keyStringPair.second);
+
+        if (key != keyStringPair.first)
+            renamedKeys[icode::internSymbol(keyStringPair.first)] = icode::internSymbol(key);
+    }
+
+    if (renamedKeys.size() == 0)
+        return;
+
+    for (icode::Entry& entry : function.icodeTable)
+        for (icode::Operand* op : { &entry.op1, &entry.op2, &entry.op3 })
+        {
+            if (op->operandType != icode::STR_DATA)
+                continue;
+
+            auto renamedKey = renamedKeys.find(op->name);
+
+            if (renamedKey != renamedKeys.end())
+                op->name = renamedKey->second;
+        }
+}
+
+void generateFunctionsInParallel(generator::GeneratorContext& ctx, const std::vector<const Node*>& functionNodes)
+{
+    /* Each worker generates in its own context, into a copy of the function description. The copies are
+        moved into the module once all workers are done, so workers only read the modules map. Operand ids
+        are then renumbered and string data keys are given in function order, so the IR is the same as
+        when generating serially */
+
+    const unsigned int jobs = ctx.functionJobs.getJobs();
+    const unsigned int workerFirstId = 1u << 31;
+
+    std::vector<std::unique_ptr<generator::GeneratorContext>> workerContexts;
+
+    for (unsigned int i = 0; i < jobs; i += 1)
+    {
+        workerContexts.push_back(std::make_unique<generator::GeneratorContext>(ctx.modulesMap,
+                                                                               ctx.genericsMap,
+                                                                               ctx.instantiationMemo,
+                                                                               ctx.irCache,
+                                                                               ctx.moduleName,
+                                                                               ctx.console,
+                                                                               ctx.functionDemand,
+                                                                               ctx.functionJobs));
+
+        workerContexts.back()->mm.copyUses(ctx.mm);
+    }
+
+    icode::ModuleDescription& module = ctx.modulesMap.at(ctx.moduleName);
+
+    std::vector<std::string> functionNames;
+
+    for (const Node* functionNode : functionNodes)
+        functionNames.push_back(getFunctionName(ctx, *functionNode));
+
+    std::vector<icode::FunctionDescription> functions(functionNodes.size());
+    std::vector<unsigned int> idCounts(functionNodes.size());
+    std::vector<std::vector<std::pair<std::string, std::string>>> stringData(functionNodes.size());
+
+    ctx.functionJobs.run(functionNodes.size(),
+                         [&](unsigned int workerIndex, size_t functionIndex)
+                         {
+                             generator::GeneratorContext& workerContext = *workerContexts[workerIndex];
+
+                             functions[functionIndex] = module.functions.at(functionNames[functionIndex]);
+                             workerContext.ir.setWorkingFunction(&functions[functionIndex]);
+                             workerContext.ir.opBuilder.setIdCounter(workerFirstId);
+                             workerContext.ir.moduleBuilder.deferStringData(&stringData[functionIndex]);
+
+                             generateFunctionBody(workerContext, *functionNodes[functionIndex]);
+
+                             idCounts[functionIndex] = workerContext.ir.opBuilder.getIdCounter() - workerFirstId;
+                         });
+
+    unsigned int nextId = ctx.ir.opBuilder.getIdCounter();
+
+    for (size_t i = 0; i < functionNodes.size(); i += 1)
+    {
+        moveOperandIds(functions[i], workerFirstId, nextId);
+        nextId += idCounts[i];
+
+        resolveStringData(ctx, functions[i], stringData[i]);
+
+        module.functions.at(functionNames[i]) = std::move(functions[i]);
+    }
+
+    ctx.ir.opBuilder.setIdCounter(nextId);
+}
+
+void generateSymbols(generator::GeneratorContext& ctx, const Node& root)
 {
+    timer::ScopedPhase phase("Symbol generation", ctx.moduleName);
+
     for (const Node& child : root.children)
         generateIncompleteType(ctx, child);
 
     for (const Node& child : root.children)
         generateSymbol(ctx, child);
+}
+
+void generateModule(generator::GeneratorContext& ctx, const Node& root)
+{
+    generateSymbols(ctx, root);
+
+    timer::ScopedPhase phase("Function generation", ctx.moduleName);
+
+    std::vector<const Node*> functionNodes;
 
     for (const Node& child : root.children)
         if (child.type == node::FUNCTION || child.type == node::FUNCTION_EXTERN_C)
-            generateFunction(ctx, child);
+            functionNodes.push_back(&child);
+
+    ctx.ir.moduleBuilder.fixStringDataModules();
+
+    if (ctx.functionJobs.canRunInParallel(functionNodes.size()))
+    {
+        generateFunctionsInParallel(ctx, functionNodes);
+        return;
+    }
+
+    for (const Node* functionNode : functionNodes)
+        generateFunction(ctx, *functionNode);
+}
+
+void generateUsedModule(generator::GeneratorContext& ctx, const std::string& moduleName, const AST& ast)
+{
+    generator::GeneratorContext generatorContext = ctx.clone(moduleName);
+    generateModule(generatorContext, ast.getRoot());
+}
+
+void generateInstantiatedModule(generator::GeneratorContext& ctx, const std::string& moduleName, const AST& ast)
+{
+    generator::DeferredModule& deferredModule = ctx.functionDemand.deferModule(ctx, moduleName, ast);
+
+    generateSymbols(*deferredModule.ctx, ast.getRoot());
+    deferredModule.ctx->ir.moduleBuilder.fixStringDataModules();
+
+    deferredModule.firstId = deferredModule.ctx->ir.opBuilder.getIdCounter();
+}
+
+void generateRootModule(Console& console,
+                        const std::string& moduleName,
+                        IRCache& irCache,
+                        icode::StringModulesMap& modulesMap,
+                        monomorphizer::StringGenericASTMap& genericsMap,
+                        monomorphizer::InstantiationMemo& instantiationMemo,
+                        generator::FunctionDemand& functionDemand,
+                        generator::FunctionJobs& functionJobs)
+{
+    const AST ast = generator::generateAST(console);
+
+    if (ast.getRoot().isGenericModule())
+        console.compileErrorOnToken("Cannot compile a generic module", ast.getRoot().children[0].tok);
+
+    irCache.beginModule(moduleName);
+
+    generator::GeneratorContext generatorContext(modulesMap,
+                                                 genericsMap,
+                                                 instantiationMemo,
+                                                 irCache,
+                                                 moduleName,
+                                                 console,
+                                                 functionDemand,
+                                                 functionJobs);
+    generateModule(generatorContext, ast.getRoot());
+}
+
+bool generateRootModules(Console& console,
+                         const std::vector<std::string>& moduleNames,
+                         IRCache& irCache,
+                         icode::StringModulesMap& modulesMap,
+                         monomorphizer::StringGenericASTMap& genericsMap,
+                         generator::FunctionJobs& functionJobs)
+{
+    /* A previous compile using the same cache could have stopped with an error while generating modules */
+    irCache.clearPendingModules();
+
+    monomorphizer::InstantiationMemo instantiationMemo;
+    generator::FunctionDemand functionDemand;
+
+    for (const std::string& moduleName : moduleNames)
+    {
+        /* Already generated as a module used by an earlier root module */
+        if (keyExistsInMap(modulesMap, moduleName))
+            continue;
+
+        functionDemand.setRootModule(moduleName);
+
+        console.pushRootModule(moduleName);
+        generateRootModule(console,
+                           moduleName,
+                           irCache,
+                           modulesMap,
+                           genericsMap,
+                           instantiationMemo,
+                           functionDemand,
+                           functionJobs);
+        console.popModule();
+    }
+
+    if (!functionDemand.generateDemandedFunctions(modulesMap))
+        return false;
+
+    /* Stored before the undemanded functions are removed, a later compile could call them */
+    irCache.storeEndedModules(modulesMap);
+    functionDemand.removeUndemandedFunctions(modulesMap);
+
+    return true;
 }
 
 void generator::generateIR(Console& console,
-                           const std::string& moduleName,
+                           const std::vector<std::string>& moduleNames,
+                           IRCache& irCache,
                            icode::StringModulesMap& modulesMap,
-                           monomorphizer::StringGenericASTMap& genericsMap)
+                           monomorphizer::StringGenericASTMap& genericsMap,
+                           FunctionJobs& functionJobs)
 {
+    if (generateRootModules(console, moduleNames, irCache, modulesMap, genericsMap, functionJobs))
+        return;
 
-    Node ast = generateAST(console);
+    /* An instantiated module loaded from the IR cache lacks a body this compile demands, generate
+        everything again without loading from the cache */
+    modulesMap.clear();
+    irCache.setLoadsEnabled(false);
 
-    if (ast.isGenericModule())
-        console.compileErrorOnToken("Cannot compile a generic module", ast.children[0].tok);
+    try
+    {
+        if (!generateRootModules(console, moduleNames, irCache, modulesMap, genericsMap, functionJobs))
+            console.internalBugError();
+    }
+    catch (...)
+    {
+        irCache.setLoadsEnabled(true);
+        throw;
+    }
 
-    generator::GeneratorContext generatorContext(modulesMap, genericsMap, moduleName, console);
-    generateModule(generatorContext, ast);
+    irCache.setLoadsEnabled(true);
 }
@@ -3,17 +3,21 @@
 
 #include "../Console/Console.hpp"
 #include "../IntermediateRepresentation/ModuleDescription.hpp"
-#include "../Node/Node.hpp"
+#include "../Node/AST.hpp"
 #include "GeneratorContext.hpp"
 
 namespace generator
 {
-    Node generateAST(Console& console);
+    AST generateAST(Console& console);
 
+    /* Generates the root modules in order into one modules map, a root module used by an earlier one
+        is not generated again */
     void generateIR(Console& console,
-                    const std::string& moduleName,
+                    const std::vector<std::string>& moduleNames,
+                    IRCache& irCache,
                     icode::StringModulesMap& modulesMap,
-                    monomorphizer::StringGenericASTMap& genericsMap);
+                    monomorphizer::StringGenericASTMap& genericsMap,
+                    FunctionJobs& functionJobs);
 }
 
 #endif
\ No newline at end of file
@@ -1,18 +1,23 @@
 #ifndef GENERATOR_MONOMORPHIZER_GENERIC_AST_INDEX
 #define GENERATOR_MONOMORPHIZER_GENERIC_AST_INDEX
 
+#include <memory>
 #include <string>
 #include <vector>
 
-#include "../../Node/Node.hpp"
+#include "../../Node/AST.hpp"
+#include "../../Source/SourceManager.hpp"
 
 struct GenericASTIndex
 {
-    Node ast;
+    AST ast;
     std::vector<std::string> genericIdentifiers;
     std::vector<std::string> genericStructs;
     std::vector<std::string> genericFunctions;
 
+    /* Tokens of the AST point into this file, it stays mapped as long as the index is kept */
+    std::shared_ptr<const source::SourceFile> source;
+
     bool isGenericStructOrFunction(const Token& name) const;
 };
 
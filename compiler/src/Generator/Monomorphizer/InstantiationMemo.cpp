@@ -0,0 +1,85 @@
+#include <atomic>
+
+#include "InstantiationMemo.hpp"
+
+namespace monomorphizer
+{
+    static std::atomic<unsigned long> hits(0);
+    static std::atomic<unsigned long> misses(0);
+
+    int compareTypes(const icode::TypeDescription& a, const icode::TypeDescription& b)
+    {
+        /* Compares what the name of the instantiated module is made of */
+
+        if (int result = a.dtypeName.compare(b.dtypeName))
+            return result;
+
+        if (int result = a.moduleName.compare(b.moduleName))
+            return result;
+
+        if (a.isPointer() != b.isPointer())
+            return a.isPointer() ? 1 : -1;
+
+        if (a.dimensions != b.dimensions)
+            return a.dimensions < b.dimensions ? -1 : 1;
+
+        return 0;
+    }
+
+    bool InstantiationTypesLess::operator()(const std::vector<icode::TypeDescription>& a,
+                                            const std::vector<icode::TypeDescription>& b) const
+    {
+        if (a.size() != b.size())
+            return a.size() < b.size();
+
+        for (size_t i = 0; i < a.size(); i += 1)
+            if (int result = compareTypes(a[i], b[i]))
+                return result < 0;
+
+        return false;
+    }
+
+    bool InstantiationMemo::getInstantiatedModule(const std::string& genericModuleName,
+                                                  const std::vector<icode::TypeDescription>& instantiationTypes,
+                                                  std::string& instantiatedModuleName)
+    {
+        auto genericModule = instantiatedModules.find(genericModuleName);
+
+        if (genericModule != instantiatedModules.end())
+        {
+            auto instantiatedModule = genericModule->second.find(instantiationTypes);
+
+            if (instantiatedModule != genericModule->second.end())
+            {
+                hits++;
+                instantiatedModuleName = instantiatedModule->second;
+                return true;
+            }
+        }
+
+        misses++;
+        return false;
+    }
+
+    void InstantiationMemo::addInstantiatedModule(const std::string& genericModuleName,
+                                                  const std::vector<icode::TypeDescription>& instantiationTypes,
+                                                  const std::string& instantiatedModuleName)
+    {
+        instantiatedModules[genericModuleName][instantiationTypes] = instantiatedModuleName;
+    }
+
+    InstantiationStats getInstantiationStats()
+    {
+        InstantiationStats stats;
+        stats.hits = hits;
+        stats.misses = misses;
+
+        return stats;
+    }
+
+    void resetInstantiationStats()
+    {
+        hits = 0;
+        misses = 0;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef GENERATOR_MONOMORPHIZER_INSTANTIATION_MEMO
+#define GENERATOR_MONOMORPHIZER_INSTANTIATION_MEMO
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../IntermediateRepresentation/TypeDescription.hpp"
+
+namespace monomorphizer
+{
+    struct InstantiationTypesLess
+    {
+        bool operator()(const std::vector<icode::TypeDescription>& a,
+                        const std::vector<icode::TypeDescription>& b) const;
+    };
+
+    typedef std::map<std::vector<icode::TypeDescription>, std::string, InstantiationTypesLess> TypesModuleNameMap;
+
+    struct InstantiationStats
+    {
+        unsigned long hits = 0;
+        unsigned long misses = 0;
+    };
+
+    /* Names of the modules instantiated from a generic module, by generic module name and instantiation
+        types. One memo is shared by all modules generated in a compile, so a generic is instantiated and
+        named once however many times it is used */
+    class InstantiationMemo
+    {
+        std::map<std::string, TypesModuleNameMap> instantiatedModules;
+
+    public:
+        bool getInstantiatedModule(const std::string& genericModuleName,
+                                   const std::vector<icode::TypeDescription>& instantiationTypes,
+                                   std::string& instantiatedModuleName);
+
+        void addInstantiatedModule(const std::string& genericModuleName,
+                                   const std::vector<icode::TypeDescription>& instantiationTypes,
+                                   const std::string& instantiatedModuleName);
+    };
+
+    /* Hits and misses of all memos since the start or the last reset, reported by -time-phases */
+    InstantiationStats getInstantiationStats();
+
+    void resetInstantiationStats();
+}
+
+#endif
@@ -1,21 +1,25 @@
-#include <algorithm>
+#include <map>
 
 #include "../../Builder/NameMangle.hpp"
 #include "../../Utils/ItemInList.hpp"
 #include "GenericASTIndex.hpp"
 #include "Instantiator.hpp"
 
+/* Nodes are addressed by their index in the AST being instantiated, references to nodes become invalid
+    when the children of a node are replaced since that can grow the arena */
+
 struct InstiatorContext
 {
-    std::string& genericIdentifier;
-    Token& typeRootToken;
-    Node& instTypeNode;
-    icode::TypeDescription& instantiationType;
+    AST& ast;
+    const std::map<std::string, size_t>& typeParamIndices;
+    const Token& typeRootToken;
+    const std::vector<std::vector<Node>>& instTypeChildren;
+    const std::vector<icode::TypeDescription>& instantiationTypes;
     Console& console;
 };
 
-void block(const InstiatorContext& ctx, Node& root);
-void expression(const InstiatorContext& ctx, Node& root);
+void block(const InstiatorContext& ctx, uint32_t root);
+void expression(const InstiatorContext& ctx, uint32_t root);
 
 Token modToken(const Token& tok, const std::string& tokenString)
 {
@@ -31,8 +35,38 @@ Node constructNode(const node::NodeType nodeType, const std::string& tokenString
     return node;
 }
 
-void validateTypeNode(const InstiatorContext& ctx, Node& root)
+bool getTypeParamIndex(const InstiatorContext& ctx, const Token& token, size_t& typeParamIndex)
+{
+    /* Finds the generic identifier the token names, if any */
+
+    auto typeParam = ctx.typeParamIndices.find(token.toString());
+
+    if (typeParam == ctx.typeParamIndices.end())
+        return false;
+
+    typeParamIndex = typeParam->second;
+    return true;
+}
+
+std::vector<Node> getChildren(const Node& root)
+{
+    return std::vector<Node>(root.children.begin(), root.children.end());
+}
+
+size_t childCount(const InstiatorContext& ctx, uint32_t root)
 {
+    return ctx.ast.getNode(root).children.size();
+}
+
+uint32_t nthChild(const InstiatorContext& ctx, uint32_t root, size_t N)
+{
+    return ctx.ast.getChildIndex(root, N);
+}
+
+void validateTypeNode(const InstiatorContext& ctx, uint32_t rootIndex)
+{
+    const Node& root = ctx.ast.getNode(rootIndex);
+
     size_t childNodeCounter = 1;
     int typeModifierCount = 0;
 
@@ -64,8 +98,10 @@ void validateTypeNode(const InstiatorContext& ctx, Node& root)
         ctx.console.compileErrorOnToken("Invalid type parameters for this generic", ctx.typeRootToken);
 }
 
-void monomorphizeTypeNode(const InstiatorContext& ctx, Node& root)
+void monomorphizeTypeNode(const InstiatorContext& ctx, uint32_t rootIndex)
 {
+    const Node& root = ctx.ast.getNode(rootIndex);
+
     size_t childNodeCounter = 1;
     if (root.type == node::GENERIC_TYPE_PARAM || root.type == node::MAKE || root.type == node::SIZEOF)
         childNodeCounter = 0;
@@ -79,112 +115,122 @@ void monomorphizeTypeNode(const InstiatorContext& ctx, Node& root)
     if (childNodeCounter >= root.children.size())
         return;
 
-    if (root.getNthChildToken(childNodeCounter).toString() == ctx.genericIdentifier)
+    size_t typeParamIndex;
+
+    if (getTypeParamIndex(ctx, root.getNthChildToken(childNodeCounter), typeParamIndex))
     {
-        root.children.erase(root.children.begin() + childNodeCounter);
+        const std::vector<Node>& instTypeChildren = ctx.instTypeChildren[typeParamIndex];
+        std::vector<Node> children = getChildren(root);
 
-        root.children.insert(root.children.begin() + childNodeCounter,
-                             ctx.instTypeNode.children.begin(),
-                             ctx.instTypeNode.children.end());
+        children.erase(children.begin() + childNodeCounter);
+        children.insert(children.begin() + childNodeCounter, instTypeChildren.begin(), instTypeChildren.end());
 
-        validateTypeNode(ctx, root);
+        ctx.ast.setChildren(rootIndex, children);
+
+        validateTypeNode(ctx, rootIndex);
 
         return;
     }
 
     childNodeCounter++;
 
-    while (root.isNthChild(node::GENERIC_TYPE_PARAM, childNodeCounter))
+    while (ctx.ast.getNode(rootIndex).isNthChild(node::GENERIC_TYPE_PARAM, childNodeCounter))
     {
-        monomorphizeTypeNode(ctx, root.children[childNodeCounter]);
-        validateTypeNode(ctx, root.children[childNodeCounter]);
+        monomorphizeTypeNode(ctx, nthChild(ctx, rootIndex, childNodeCounter));
+        validateTypeNode(ctx, nthChild(ctx, rootIndex, childNodeCounter));
 
         childNodeCounter++;
     }
 }
 
-void cast(const InstiatorContext& ctx, Node& root)
+void cast(const InstiatorContext& ctx, uint32_t root)
 {
-    const Token typeToken = root.getNthChildToken(0);
+    const Token typeToken = ctx.ast.getNode(root).getNthChildToken(0);
+
+    size_t typeParamIndex;
 
-    if (typeToken.toString() != ctx.genericIdentifier)
+    if (!getTypeParamIndex(ctx, typeToken, typeParamIndex))
         return;
 
-    root.children[0].tok = modToken(typeToken, ctx.instantiationType.dtypeName);
+    const icode::TypeDescription& instantiationType = ctx.instantiationTypes[typeParamIndex];
 
-    Node newRootNode = constructNode(node::TERM, typeToken.toString());
+    ctx.ast.getNode(nthChild(ctx, root, 0)).tok = modToken(typeToken, instantiationType.dtypeName);
 
-    const std::string alias = mangleModuleName(ctx.instantiationType.moduleName);
-    newRootNode.children.push_back(constructNode(node::MODULE, alias));
-    newRootNode.children.push_back(root);
+    const std::string alias = mangleModuleName(instantiationType.moduleName);
+    const std::vector<Node> children = { constructNode(node::MODULE, alias), ctx.ast.getNode(root) };
 
-    root = newRootNode;
+    ctx.ast.getNode(root) = constructNode(node::TERM, typeToken.toString());
+    ctx.ast.setChildren(root, children);
 }
 
-void genericFunctionCall(const InstiatorContext& ctx, Node& root)
+void genericFunctionCall(const InstiatorContext& ctx, uint32_t root)
 {
-    for (Node& child : root.children)
+    for (size_t i = 0; i < childCount(ctx, root); i += 1)
     {
-        if (child.type != node::GENERIC_TYPE_PARAM)
+        const uint32_t child = nthChild(ctx, root, i);
+
+        if (ctx.ast.getNode(child).type != node::GENERIC_TYPE_PARAM)
             expression(ctx, child);
         else
             monomorphizeTypeNode(ctx, child);
     }
 }
 
-void make(const InstiatorContext& ctx, Node& root)
+void make(const InstiatorContext& ctx, uint32_t root)
 {
-    monomorphizeTypeNode(ctx, root.children[0]);
+    monomorphizeTypeNode(ctx, nthChild(ctx, root, 0));
 
-    for (size_t i = 1; i < root.children.size(); i += 1)
-        expression(ctx, root.children[i]);
+    for (size_t i = 1; i < childCount(ctx, root); i += 1)
+        expression(ctx, nthChild(ctx, root, i));
 }
 
-void expression(const InstiatorContext& ctx, Node& root)
+void expression(const InstiatorContext& ctx, uint32_t root)
 {
-    if (root.type == node::SIZEOF)
+    const Node& rootNode = ctx.ast.getNode(root);
+
+    if (rootNode.type == node::SIZEOF)
     {
         monomorphizeTypeNode(ctx, root);
         return;
     }
 
-    if (root.type == node::MAKE)
+    if (rootNode.type == node::MAKE)
     {
         make(ctx, root);
         return;
     }
 
-    if (root.type == node::GENERIC_FUNCCALL)
+    if (rootNode.type == node::GENERIC_FUNCCALL)
     {
         genericFunctionCall(ctx, root);
         return;
     }
 
-    if (root.isNthChild(node::PTR_CAST, 0) || root.isNthChild(node::PTR_ARRAY_CAST, 0) ||
-        root.isNthChild(node::CAST, 0))
+    if (rootNode.isNthChild(node::PTR_CAST, 0) || rootNode.isNthChild(node::PTR_ARRAY_CAST, 0) ||
+        rootNode.isNthChild(node::CAST, 0))
         cast(ctx, root);
 
-    for (Node& child : root.children)
-        expression(ctx, child);
+    for (size_t i = 0; i < childCount(ctx, root); i += 1)
+        expression(ctx, nthChild(ctx, root, i));
 }
 
-void forLoop(const InstiatorContext& ctx, Node& root)
+void forLoop(const InstiatorContext& ctx, uint32_t root)
 {
-    if (root.isNthChild(node::VAR, 0))
-        monomorphizeTypeNode(ctx, root.children[0]);
+    if (ctx.ast.getNode(root).isNthChild(node::VAR, 0))
+        monomorphizeTypeNode(ctx, nthChild(ctx, root, 0));
 
-    block(ctx, root.children[3]);
+    block(ctx, nthChild(ctx, root, 3));
 }
 
-void ifStatement(const InstiatorContext& ctx, Node& root)
+void ifStatement(const InstiatorContext& ctx, uint32_t root)
 {
-    for (Node& child : root.children)
-        block(ctx, child);
+    for (size_t i = 0; i < childCount(ctx, root); i += 1)
+        block(ctx, nthChild(ctx, root, i));
 }
 
-void statement(const InstiatorContext& ctx, Node& root)
+void statement(const InstiatorContext& ctx, uint32_t root)
 {
-    switch (root.type)
+    switch (ctx.ast.getNode(root).type)
     {
         case node::VAR:
         case node::CONST:
@@ -197,13 +243,13 @@ void statement(const InstiatorContext& ctx, Node& root)
             ifStatement(ctx, root);
             break;
         case node::WHILE:
-            block(ctx, root.children[1]);
+            block(ctx, nthChild(ctx, root, 1));
             break;
         case node::DO_WHILE:
-            block(ctx, root.children[0]);
+            block(ctx, nthChild(ctx, root, 0));
             break;
         case node::LOOP:
-            block(ctx, root.children[0]);
+            block(ctx, nthChild(ctx, root, 0));
             break;
         default:
             break;
@@ -212,31 +258,33 @@ void statement(const InstiatorContext& ctx, Node& root)
     expression(ctx, root);
 }
 
-void block(const InstiatorContext& ctx, Node& root)
+void block(const InstiatorContext& ctx, uint32_t root)
 {
-    for (Node& stmt : root.children)
-        statement(ctx, stmt);
+    for (size_t i = 0; i < childCount(ctx, root); i += 1)
+        statement(ctx, nthChild(ctx, root, i));
 }
 
-void function(const InstiatorContext& ctx, Node& root)
+void function(const InstiatorContext& ctx, uint32_t root)
 {
     monomorphizeTypeNode(ctx, root);
 
-    for (size_t i = 1; root.children[i].isParamNode(); i += 1)
-        monomorphizeTypeNode(ctx, root.children[i]);
+    for (size_t i = 1; ctx.ast.getNode(root).children[i].isParamNode(); i += 1)
+        monomorphizeTypeNode(ctx, nthChild(ctx, root, i));
 
-    block(ctx, root.children.back());
+    block(ctx, nthChild(ctx, root, childCount(ctx, root) - 1));
 }
 
-void structure(const InstiatorContext& ctx, Node& root)
+void structure(const InstiatorContext& ctx, uint32_t root)
 {
-    for (Node& child : root.children[0].children)
-        monomorphizeTypeNode(ctx, child);
+    const uint32_t fields = nthChild(ctx, root, 0);
+
+    for (size_t i = 0; i < childCount(ctx, fields); i += 1)
+        monomorphizeTypeNode(ctx, nthChild(ctx, fields, i));
 }
 
-void monomorphizeTypeNodes(const InstiatorContext& ctx, Node& root)
+void monomorphizeTypeNodes(const InstiatorContext& ctx, uint32_t root)
 {
-    switch (root.type)
+    switch (ctx.ast.getNode(root).type)
     {
         case node::STRUCT:
             structure(ctx, root);
@@ -253,61 +301,59 @@ void monomorphizeTypeNodes(const InstiatorContext& ctx, Node& root)
     }
 }
 
-void instantiateASTSingle(InstiatorContext& ctx, Node& genericModuleAST)
+void monomorphizeModule(const InstiatorContext& ctx)
 {
-    for (Node& child : genericModuleAST.children)
-        monomorphizeTypeNodes(ctx, child);
+    for (size_t i = 0; i < childCount(ctx, 0); i += 1)
+        monomorphizeTypeNodes(ctx, nthChild(ctx, 0, i));
 }
 
-void prependUseNode(Node& root, const std::string& moduleName, const std::string& alias)
+void prependUseNode(AST& genericModuleAST, const std::string& moduleName, const std::string& alias)
 {
-    Node useNode = constructNode(node::USE, "use");
-    useNode.children.push_back(constructNode(node::STR_LITERAL, '\"' + moduleName + '\"'));
-    useNode.children.push_back(constructNode(node::IDENTIFIER, alias));
+    AST useNode(constructNode(node::USE, "use"));
+    useNode.setChildren(0,
+                        { constructNode(node::STR_LITERAL, '\"' + moduleName + '\"'),
+                          constructNode(node::IDENTIFIER, alias) });
 
-    root.children.insert(root.children.begin(), useNode);
+    std::vector<Node> children = getChildren(genericModuleAST.getRoot());
+    children.insert(children.begin(), useNode.getRoot());
+
+    genericModuleAST.setChildren(0, children);
 }
 
-void stripModulesFromTypeNode(Node& root)
+std::vector<Node> getInstTypeChildren(const Node& typeNode, const std::string& alias)
 {
-    int numModuleNodes = 0;
+    /* Children of the type node with the modules replaced by the alias of the type's module and
+        without generic type params */
 
-    while (root.isNthChild(node::MODULE, numModuleNodes))
-        numModuleNodes++;
+    std::vector<Node> children = { constructNode(node::MODULE, alias) };
 
-    root.children.erase(root.children.begin(), root.children.begin() + numModuleNodes);
-}
+    size_t numModuleNodes = 0;
 
-void stripGenericTypeParamsFromTypeNode(Node& root)
-{
-    root.children.erase(std::remove_if(root.children.begin(),
-                                       root.children.end(),
-                                       [](const Node& node) { return node.type == node::GENERIC_TYPE_PARAM; }),
-                        root.children.end());
-}
+    while (typeNode.isNthChild(node::MODULE, numModuleNodes))
+        numModuleNodes++;
 
-void prependModuleToTypeNode(Node& root, const std::string& alias)
-{
-    root.children.insert(root.children.begin(), constructNode(node::MODULE, alias));
+    for (size_t i = numModuleNodes; i < typeNode.children.size(); i += 1)
+        if (typeNode.children[i].type != node::GENERIC_TYPE_PARAM)
+            children.push_back(typeNode.children[i]);
+
+    return children;
 }
 
-void prependUseNodesInPlace(const std::vector<icode::TypeDescription>& instantiationTypes,
-                            std::vector<Node>& instTypeNodes,
-                            Node& genericModuleAST)
+std::vector<std::vector<Node>> prependUseNodesInPlace(const std::vector<icode::TypeDescription>& instantiationTypes,
+                                                      const std::vector<Node>& instTypeNodes,
+                                                      AST& genericModuleAST)
 {
     std::vector<std::string> prependedModules;
+    std::vector<std::vector<Node>> instTypeChildren;
 
     for (size_t i = 0; i < instantiationTypes.size(); i += 1)
     {
-        const icode::TypeDescription type = instantiationTypes[i];
-        Node& typeNode = instTypeNodes[i];
+        const icode::TypeDescription& type = instantiationTypes[i];
 
         const std::string moduleName = type.moduleName;
         const std::string alias = mangleModuleName(moduleName);
 
-        stripModulesFromTypeNode(typeNode);
-        prependModuleToTypeNode(typeNode, alias);
-        stripGenericTypeParamsFromTypeNode(typeNode);
+        instTypeChildren.push_back(getInstTypeChildren(instTypeNodes[i], alias));
 
         if (itemInList<std::string>(moduleName, prependedModules))
             continue;
@@ -316,28 +362,35 @@ void prependUseNodesInPlace(const std::vector<icode::TypeDescription>& instantia
 
         prependUseNode(genericModuleAST, moduleName, alias);
     }
+
+    return instTypeChildren;
 }
 
-Node instantiateAST(GenericASTIndex index,
-                    Token typeRootToken,
-                    std::vector<icode::TypeDescription> instantiationTypes,
-                    std::vector<Node> instTypeNodes,
-                    Console& console)
+AST instantiateAST(const GenericASTIndex& index,
+                   const Token& typeRootToken,
+                   const std::vector<icode::TypeDescription>& instantiationTypes,
+                   const std::vector<Node>& instTypeNodes,
+                   Console& console)
 {
-    Node genericModuleAST = index.ast;
+    AST genericModuleAST = index.ast.clone();
 
-    prependUseNodesInPlace(instantiationTypes, instTypeNodes, genericModuleAST);
+    const std::vector<std::vector<Node>> instTypeChildren =
+        prependUseNodesInPlace(instantiationTypes, instTypeNodes, genericModuleAST);
+
+    /* All generic identifiers are substituted in a single pass over the AST */
+    std::map<std::string, size_t> typeParamIndices;
 
     for (size_t i = 0; i < index.genericIdentifiers.size(); i += 1)
-    {
-        InstiatorContext ctx = InstiatorContext{ index.genericIdentifiers[i],
-                                                 typeRootToken,
-                                                 instTypeNodes[i],
-                                                 instantiationTypes[i],
-                                                 console };
+        typeParamIndices.emplace(index.genericIdentifiers[i], i);
 
-        instantiateASTSingle(ctx, genericModuleAST);
-    }
+    const InstiatorContext ctx = InstiatorContext{ genericModuleAST,
+                                                   typeParamIndices,
+                                                   typeRootToken,
+                                                   instTypeChildren,
+                                                   instantiationTypes,
+                                                   console };
+
+    monomorphizeModule(ctx);
 
     return genericModuleAST;
 }
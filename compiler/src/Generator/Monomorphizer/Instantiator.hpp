@@ -6,13 +6,13 @@
 
 #include "../../Console/Console.hpp"
 #include "../../IntermediateRepresentation/TypeDescription.hpp"
-#include "../../Node/Node.hpp"
+#include "../../Node/AST.hpp"
 #include "GenericASTIndex.hpp"
 
-Node instantiateAST(GenericASTIndex index,
-                    Token typeRootToken,
-                    std::vector<icode::TypeDescription> instantiationTypes,
-                    std::vector<Node> instTypeNodes,
-                    Console& console);
+AST instantiateAST(const GenericASTIndex& index,
+                   const Token& typeRootToken,
+                   const std::vector<icode::TypeDescription>& instantiationTypes,
+                   const std::vector<Node>& instTypeNodes,
+                   Console& console);
 
 #endif
\ No newline at end of file
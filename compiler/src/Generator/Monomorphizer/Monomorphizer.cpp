@@ -21,6 +21,13 @@ void Monomorphizer::resetWorkingModule()
     workingModule = "";
 }
 
+void Monomorphizer::copyUses(const Monomorphizer& other)
+{
+    aliases = other.aliases;
+    uses = other.uses;
+    genericUses = other.genericUses;
+}
+
 std::vector<std::string> getGenericIdentifiers(const Node& root)
 {
     std::vector<std::string> genericIdentifiers;
@@ -81,15 +88,18 @@ std::pair<std::vector<std::string>, std::vector<std::string>> Monomorphizer::get
     return { genericStructs, genericFunctions };
 }
 
-void Monomorphizer::indexAST(const std::string& genericModuleName, const Node& ast)
+void Monomorphizer::indexAST(const std::string& genericModuleName, const AST& ast)
 {
-    std::vector<std::string> genericIdentifiers = getGenericIdentifiers(ast);
-    auto genericStructsAndFunctions = getGenericStructsAndFunctions(ast, genericIdentifiers);
+    std::vector<std::string> genericIdentifiers = getGenericIdentifiers(ast.getRoot());
+    auto genericStructsAndFunctions = getGenericStructsAndFunctions(ast.getRoot(), genericIdentifiers);
 
-    GenericASTIndex index =
-        GenericASTIndex{ ast, genericIdentifiers, genericStructsAndFunctions.first, genericStructsAndFunctions.second };
+    const GenericASTIndex index = GenericASTIndex{ ast,
+                                                   genericIdentifiers,
+                                                   genericStructsAndFunctions.first,
+                                                   genericStructsAndFunctions.second,
+                                                   console.getSharedSource() };
 
-    genericsMap[genericModuleName] = index;
+    genericsMap[genericModuleName] = std::make_shared<const GenericASTIndex>(index);
 }
 
 void Monomorphizer::createUse(const Token& pathToken, const Token& aliasToken)
@@ -114,7 +124,7 @@ bool Monomorphizer::aliasExists(const Token& aliasToken)
 
 void Monomorphizer::createFrom(const std::string& genericModuleName, const Token& symbolToken)
 {
-    GenericASTIndex index = genericsMap.at(genericModuleName);
+    const GenericASTIndex& index = *genericsMap.at(genericModuleName);
 
     if (!index.isGenericStructOrFunction(symbolToken))
         console.compileErrorOnToken("Generic does not exist", symbolToken);
@@ -174,7 +184,7 @@ std::string Monomorphizer::getGenericModuleFromToken(const Token& token)
     if (workingModule.size() == 0)
         return getGenericModuleNameFromUse(token);
 
-    const GenericASTIndex index = genericsMap.at(workingModule);
+    const GenericASTIndex& index = *genericsMap.at(workingModule);
 
     if (!index.isGenericStructOrFunction(token))
         console.compileErrorOnToken("Generic does not exist", token);
@@ -187,17 +197,17 @@ bool Monomorphizer::genericExists(const Token& token)
     if (workingModule.size() == 0)
         return keyExistsInMap(genericUses, token.toString());
 
-    const GenericASTIndex index = genericsMap.at(workingModule);
+    const GenericASTIndex& index = *genericsMap.at(workingModule);
 
     return index.isGenericStructOrFunction(token);
 }
 
-Node Monomorphizer::instantiateGeneric(const std::string& genericModuleName,
-                                       const Token& genericNameToken,
-                                       const std::vector<icode::TypeDescription>& instantiationTypes,
-                                       const std::vector<Node>& instantiationTypeNodes)
+AST Monomorphizer::instantiateGeneric(const std::string& genericModuleName,
+                                      const Token& genericNameToken,
+                                      const std::vector<icode::TypeDescription>& instantiationTypes,
+                                      const std::vector<Node>& instantiationTypeNodes)
 {
-    const GenericASTIndex index = genericsMap.at(genericModuleName);
+    const GenericASTIndex& index = *genericsMap.at(genericModuleName);
 
     if (index.genericIdentifiers.size() != instantiationTypes.size())
         console.compileErrorOnToken("Number of type parameters don't match", genericNameToken);
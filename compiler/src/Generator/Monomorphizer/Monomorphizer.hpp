@@ -2,17 +2,20 @@
 #define GENERATOR_MONOMORPHIZER_MONOMORPHIZER
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "../../Console/Console.hpp"
 #include "../../IntermediateRepresentation/TypeDescription.hpp"
-#include "../../Node/Node.hpp"
+#include "../../Node/AST.hpp"
 #include "GenericASTIndex.hpp"
+#include "InstantiationMemo.hpp"
 
 namespace monomorphizer
 {
-    typedef std::map<std::string, GenericASTIndex> StringGenericASTMap;
+    /* Generic modules are indexed once and never modified, instantiating one clones its AST */
+    typedef std::map<std::string, std::shared_ptr<const GenericASTIndex>> StringGenericASTMap;
 
     class Monomorphizer
     {
@@ -39,7 +42,12 @@ namespace monomorphizer
 
         Monomorphizer(StringGenericASTMap& genericsMap, Console& console);
 
-        void indexAST(const std::string& genericModuleName, const Node& ast);
+        /* Called with the console in the generic module, the file of the module is kept mapped
+            along with the AST */
+        void indexAST(const std::string& genericModuleName, const AST& ast);
+
+        /* For generating functions of the same module in another context */
+        void copyUses(const Monomorphizer& other);
 
         void createUse(const Token& pathToken, const Token& aliasToken);
 
@@ -59,10 +67,10 @@ namespace monomorphizer
 
         bool genericExists(const Token& token);
 
-        Node instantiateGeneric(const std::string& genericModuleName,
-                                const Token& genericNameToken,
-                                const std::vector<icode::TypeDescription>& instantiationTypes,
-                                const std::vector<Node>& instantiationTypeNodes);
+        AST instantiateGeneric(const std::string& genericModuleName,
+                               const Token& genericNameToken,
+                               const std::vector<icode::TypeDescription>& instantiationTypes,
+                               const std::vector<Node>& instantiationTypeNodes);
     };
 };
 
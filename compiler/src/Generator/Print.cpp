@@ -9,7 +9,7 @@ Unit coerceToCharArray(generator::GeneratorContext& ctx, const Token& token, con
 
     if (ctx.ir.finder.methodExists(unit.type(), toCharArrayHook))
     {
-        const icode::FunctionDescription charArrayFunc = ctx.ir.finder.getMethod(unit.type(), toCharArrayHook);
+        const icode::FunctionDescription& charArrayFunc = ctx.ir.finder.getMethod(unit.type(), toCharArrayHook);
 
         if (!charArrayFunc.functionReturnType.isSingleDimCharArray())
             ctx.console.compileErrorOnToken("Invalid return type for method " + toCharArrayHook, token);
@@ -18,7 +18,7 @@ Unit coerceToCharArray(generator::GeneratorContext& ctx, const Token& token, con
     }
     else if (ctx.ir.finder.methodExists(unit.type(), toStringHook))
     {
-        const icode::FunctionDescription stringFunc = ctx.ir.finder.getMethod(unit.type(), toStringHook);
+        const icode::FunctionDescription& stringFunc = ctx.ir.finder.getMethod(unit.type(), toStringHook);
 
         const Unit stringReturn = createCallFunction(ctx, { token }, { unit }, stringFunc, token);
 
@@ -126,7 +126,7 @@ Unit forEachLoopInitCounter(generator::GeneratorContext ctx)
 
 std::vector<Unit> forEachLoopInitItemSingle(generator::GeneratorContext& ctx,
                                             const Node& root,
-                                            FunctionDescription subscriptFunc)
+                                            const FunctionDescription& subscriptFunc)
 {
     const Token itemToken = root.getNthChildToken(0);
 
@@ -198,7 +198,7 @@ std::vector<Unit> forEachLoopInitItemNamedDestructure(generator::GeneratorContex
 
 std::vector<Unit> forEachLoopInitItem(generator::GeneratorContext& ctx,
                                       const Node& root,
-                                      FunctionDescription subscriptFunc)
+                                      const FunctionDescription& subscriptFunc)
 {
 
     if (!root.isNthChild(node::DESTRUCTURE_LIST, 0))
@@ -246,8 +246,8 @@ void forEachLoop(generator::GeneratorContext& ctx, const Node& root)
     Unit generator = expression(ctx, root.children[1]);
 
     /* Get generator methods */
-    FunctionDescription lenFunc = ctx.ir.finder.getMethodFromUnit(generator, "length", expressionToken);
-    FunctionDescription subscriptFunc =
+    const FunctionDescription& lenFunc = ctx.ir.finder.getMethodFromUnit(generator, "length", expressionToken);
+    const FunctionDescription& subscriptFunc =
         ctx.ir.finder.getMethodFromUnit(generator, "__subscriptItem__", expressionToken);
 
     /* Declare for each element as local  */
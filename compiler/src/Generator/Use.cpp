@@ -1,12 +1,14 @@
 #include <filesystem>
 
+#include "../Utils/PhaseTimer.hpp"
+
 #include "Use.hpp"
 
-void generateModule(generator::GeneratorContext& ctx, const Node& root);
+void generateUsedModule(generator::GeneratorContext& ctx, const std::string& moduleName, const AST& ast);
 
 namespace generator
 {
-    Node generateAST(Console& console);
+    AST generateAST(Console& console);
 }
 
 bool generateIROrMonomorphizedASTFromName(generator::GeneratorContext& ctx, const Token& pathToken)
@@ -19,18 +21,27 @@ bool generateIROrMonomorphizedASTFromName(generator::GeneratorContext& ctx, cons
     if (ctx.genericModuleExists(path))
         return true;
 
+    if (ctx.irCache.loadModules(path, ctx.modulesMap))
+        return false;
+
     ctx.console.pushModuleToken(pathToken);
 
-    Node ast = generator::generateAST(ctx.console);
+    const AST ast = generator::generateAST(ctx.console);
 
-    const bool isGeneric = ast.isGenericModule();
+    const bool isGeneric = ast.getRoot().isGenericModule();
 
     if (isGeneric)
+    {
+        timer::ScopedPhase phase("Monomorphization", path);
         ctx.mm.indexAST(path, ast);
+    }
     else
     {
-        generator::GeneratorContext generatorContext = ctx.clone(path);
-        generateModule(generatorContext, ast);
+        ctx.irCache.beginModule(path);
+
+        generateUsedModule(ctx, path, ast);
+
+        ctx.irCache.endModule(path);
     }
 
     ctx.console.popModule();
@@ -0,0 +1,304 @@
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA1.h"
+
+#include "../Console/ModuleSearch.hpp"
+#include "../IntermediateRepresentation/ModuleReferences.hpp"
+#include "../Utils/CachePath.hpp"
+#include "../Utils/PhaseTimer.hpp"
+#include "../config.hpp"
+#include "IRReader.hpp"
+#include "IRWriter.hpp"
+
+#include "IRCache.hpp"
+
+namespace fs = std::filesystem;
+
+/* A .shtkir file holds the IR of a used module along with the IR of every module it refers to, and
+    the hash of every source file that went into generating them. A cached file is used only if all
+    of those source files are unchanged. A resident cache keeps the same in memory, so a long running
+    compiler can reuse modules between compiles */
+
+IRCache::IRCache(bool enabled, bool resident)
+    : enabled(enabled)
+    , resident(resident)
+    , loadsEnabled(true)
+{
+    cacheDirectory = getCacheDirectory();
+}
+
+void IRCache::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+}
+
+void IRCache::setLoadsEnabled(bool loadsEnabled)
+{
+    this->loadsEnabled = loadsEnabled;
+}
+
+void IRCache::clearPendingModules()
+{
+    pendingModules.clear();
+    endedModules.clear();
+}
+
+void IRCache::beginModule(const std::string& moduleName)
+{
+    pendingModules.insert(moduleName);
+}
+
+void IRCache::endModule(const std::string& moduleName)
+{
+    pendingModules.erase(moduleName);
+    endedModules.push_back(moduleName);
+}
+
+std::string getSourceModuleName(const std::string& moduleName)
+{
+    /* Instantiated generic modules are named after the generic module followed by the
+        instantiation types in brackets, brackets are not allowed in module names */
+    return moduleName.substr(0, moduleName.find('['));
+}
+
+std::string hashBuffer(llvm::StringRef buffer)
+{
+    llvm::SHA1 sha;
+    sha.update(buffer);
+    return llvm::toHex(sha.final(), true);
+}
+
+std::string IRCache::getSourceHash(const std::string& moduleName)
+{
+    const std::string absolutePath = getAbsoluteModulePath(moduleName);
+
+    if (absolutePath == "")
+        return "";
+
+    /* The file is hashed again only if its modification time or size has changed since it was last hashed */
+
+    std::error_code ec;
+    const fs::file_time_type modifiedTime = fs::last_write_time(absolutePath, ec);
+    const std::uintmax_t size = fs::file_size(absolutePath, ec);
+
+    if (ec)
+        return "";
+
+    auto sourceStampPair = sourceStamps.find(absolutePath);
+
+    if (sourceStampPair != sourceStamps.end() && sourceStampPair->second.modifiedTime == modifiedTime &&
+        sourceStampPair->second.size == size)
+        return sourceStampPair->second.hash;
+
+    auto bufferOrError = llvm::MemoryBuffer::getFile(absolutePath);
+
+    if (!bufferOrError)
+        return "";
+
+    const std::string hash = hashBuffer(bufferOrError.get()->getBuffer());
+    sourceStamps[absolutePath] = SourceStamp{ modifiedTime, size, hash };
+
+    return hash;
+}
+
+std::string getCachedIRPath(const std::string& cacheDirectory, const std::string& moduleName)
+{
+    std::error_code ec;
+    const fs::path absolutePath = fs::absolute(getAbsoluteModulePath(getSourceModuleName(moduleName)), ec);
+
+    const std::string key = hashBuffer(std::string(VERSION) + '\0' + moduleName + '\0' + absolutePath.string());
+
+    return (fs::path(cacheDirectory) / (key + ".shtkir")).string();
+}
+
+bool IRCache::dependenciesUnchanged(const std::map<std::string, std::string>& dependencies)
+{
+    for (const auto& dependency : dependencies)
+        if (getSourceHash(dependency.first) != dependency.second)
+            return false;
+
+    return true;
+}
+
+bool IRCache::insertModules(std::vector<icode::ModuleDescription>& modules, icode::StringModulesMap& modulesMap)
+{
+    /* Modules being generated right now are incomplete, the cached IR might not match what
+        generating against the incomplete module would give */
+    for (const icode::ModuleDescription& module : modules)
+        if (pendingModules.count(module.name) != 0)
+            return false;
+
+    for (icode::ModuleDescription& module : modules)
+        if (modulesMap.count(module.name) == 0)
+            modulesMap[module.name] = std::move(module);
+
+    return true;
+}
+
+bool IRCache::readCachedModules(std::string_view buffer, CachedModules& cachedModules)
+{
+    IRReader reader(buffer.data(), buffer.size());
+
+    reader.read(cachedModules.dependencies);
+
+    if (reader.hasFailed())
+        return false;
+
+    if (!dependenciesUnchanged(cachedModules.dependencies))
+        return false;
+
+    reader.read(cachedModules.modules);
+
+    return !reader.hasFailed();
+}
+
+bool IRCache::loadResidentModules(const std::string& moduleName, icode::StringModulesMap& modulesMap)
+{
+    auto residentModulesPair = residentModules.find(moduleName);
+
+    if (residentModulesPair == residentModules.end())
+        return false;
+
+    CachedModules cachedModules;
+
+    if (!readCachedModules(residentModulesPair->second, cachedModules))
+    {
+        residentModules.erase(residentModulesPair);
+        return false;
+    }
+
+    return insertModules(cachedModules.modules, modulesMap);
+}
+
+bool IRCache::loadModulesFromDisk(const std::string& moduleName, icode::StringModulesMap& modulesMap)
+{
+    auto bufferOrError = llvm::MemoryBuffer::getFile(getCachedIRPath(cacheDirectory, moduleName));
+
+    if (!bufferOrError)
+        return false;
+
+    const llvm::StringRef buffer = bufferOrError.get()->getBuffer();
+
+    CachedModules cachedModules;
+
+    if (!readCachedModules(std::string_view(buffer.data(), buffer.size()), cachedModules))
+        return false;
+
+    if (resident)
+        residentModules[moduleName] = buffer.str();
+
+    return insertModules(cachedModules.modules, modulesMap);
+}
+
+bool IRCache::loadModules(const std::string& moduleName, icode::StringModulesMap& modulesMap)
+{
+    if ((!enabled && !resident) || !loadsEnabled)
+        return false;
+
+    timer::ScopedPhase phase("IR cache loading", moduleName);
+
+    if (resident && loadResidentModules(moduleName, modulesMap))
+        return true;
+
+    if (enabled)
+        return loadModulesFromDisk(moduleName, modulesMap);
+
+    return false;
+}
+
+void IRCache::storeModulesToDisk(const std::string& moduleName, const std::string& buffer)
+{
+    /* Failing to populate the cache should not fail the build, so errors are ignored here */
+
+    const std::string cachedIRPath = getCachedIRPath(cacheDirectory, moduleName);
+
+    std::error_code ec;
+    fs::create_directories(cacheDirectory, ec);
+
+    llvm::SmallString<128> temporaryPath;
+    llvm::sys::fs::createUniquePath(cachedIRPath + "-%%%%%%%%.tmp", temporaryPath, false);
+
+    std::ofstream file(temporaryPath.str().str(), std::ios::binary);
+    file << buffer;
+    file.close();
+
+    if (!file)
+    {
+        fs::remove(temporaryPath.str().str(), ec);
+        return;
+    }
+
+    fs::rename(temporaryPath.str().str(), cachedIRPath, ec);
+
+    if (ec)
+        fs::remove(temporaryPath.str().str(), ec);
+}
+
+void IRCache::storeModules(const std::string& moduleName, const icode::StringModulesMap& modulesMap)
+{
+    if (!enabled && !resident)
+        return;
+
+    std::set<std::string> moduleNames = icode::getTransitiveReferencedModules(modulesMap, moduleName);
+    moduleNames.insert(moduleName);
+
+    CachedModules cachedModules;
+
+    for (const std::string& name : moduleNames)
+    {
+        if (pendingModules.count(name) != 0)
+            return;
+
+        const icode::ModuleDescription& module = modulesMap.at(name);
+
+        const std::string hash = getSourceHash(getSourceModuleName(name));
+
+        if (hash == "")
+            return;
+
+        cachedModules.dependencies[getSourceModuleName(name)] = hash;
+
+        /* Generic modules that are used but never instantiated are not in the modules map,
+            they are still dependencies because they could make this module fail to compile */
+        for (const std::string& use : module.uses)
+        {
+            if (modulesMap.count(use) != 0)
+                continue;
+
+            const std::string useHash = getSourceHash(use);
+
+            if (useHash == "")
+                return;
+
+            cachedModules.dependencies[use] = useHash;
+        }
+
+        cachedModules.modules.push_back(module);
+    }
+
+    IRWriter writer;
+    writer.write(cachedModules.dependencies);
+    writer.write(cachedModules.modules);
+
+    const std::string buffer = writer.getBuffer();
+
+    if (enabled)
+        storeModulesToDisk(moduleName, buffer);
+
+    if (resident)
+        residentModules[moduleName] = buffer;
+}
+
+void IRCache::storeEndedModules(const icode::StringModulesMap& modulesMap)
+{
+    for (const std::string& moduleName : endedModules)
+        storeModules(moduleName, modulesMap);
+
+    endedModules.clear();
+}
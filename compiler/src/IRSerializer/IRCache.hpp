@@ -0,0 +1,77 @@
+#ifndef IR_SERIALIZER_IR_CACHE
+#define IR_SERIALIZER_IR_CACHE
+
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../IntermediateRepresentation/All.hpp"
+
+struct SourceStamp
+{
+    std::filesystem::file_time_type modifiedTime;
+    std::uintmax_t size;
+    std::string hash;
+};
+
+struct CachedModules
+{
+    std::map<std::string, std::string> dependencies;
+    std::vector<icode::ModuleDescription> modules;
+};
+
+class IRCache
+{
+    bool enabled;
+    bool resident;
+    bool loadsEnabled;
+    std::string cacheDirectory;
+
+    std::map<std::string, SourceStamp> sourceStamps;
+    std::set<std::string> pendingModules;
+
+    /* Modules are stored only once the function bodies they demand are generated */
+    std::vector<std::string> endedModules;
+
+    /* Kept in the .shtkir format rather than as module descriptions, so no symbol id outlives
+        a compile and the symbol table can be reset between compiles */
+    std::map<std::string, std::string> residentModules;
+
+    bool dependenciesUnchanged(const std::map<std::string, std::string>& dependencies);
+
+    bool readCachedModules(std::string_view buffer, CachedModules& cachedModules);
+
+    bool insertModules(std::vector<icode::ModuleDescription>& modules, icode::StringModulesMap& modulesMap);
+
+    bool loadResidentModules(const std::string& moduleName, icode::StringModulesMap& modulesMap);
+
+    bool loadModulesFromDisk(const std::string& moduleName, icode::StringModulesMap& modulesMap);
+
+    void storeModulesToDisk(const std::string& moduleName, const std::string& buffer);
+
+    void storeModules(const std::string& moduleName, const icode::StringModulesMap& modulesMap);
+
+public:
+    IRCache(bool enabled, bool resident = false);
+
+    void setEnabled(bool enabled);
+
+    void setLoadsEnabled(bool loadsEnabled);
+
+    void clearPendingModules();
+
+    std::string getSourceHash(const std::string& moduleName);
+
+    void beginModule(const std::string& moduleName);
+
+    void endModule(const std::string& moduleName);
+
+    bool loadModules(const std::string& moduleName, icode::StringModulesMap& modulesMap);
+
+    void storeEndedModules(const icode::StringModulesMap& modulesMap);
+};
+
+#endif
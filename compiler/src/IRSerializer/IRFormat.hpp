@@ -0,0 +1,15 @@
+#ifndef IR_SERIALIZER_IR_FORMAT
+#define IR_SERIALIZER_IR_FORMAT
+
+/* Layout of a .shtkir file
+
+    magic, format version
+    string table, count followed by length and bytes of each string
+    body, everything else with strings written as an index into the string table
+
+    Integers are written using a variable length encoding */
+
+#define IR_FORMAT_MAGIC "SHTKIR"
+#define IR_FORMAT_VERSION 3
+
+#endif
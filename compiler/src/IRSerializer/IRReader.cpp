@@ -0,0 +1,258 @@
+#include <cstring>
+
+#include "IRFormat.hpp"
+
+#include "IRReader.hpp"
+
+/* The reader never trusts the input, a truncated or corrupted file sets the failed flag
+    and everything read after that is zero or empty */
+
+IRReader::IRReader(const char* data, size_t size)
+    : current(data)
+    , end(data + size)
+    , failed(false)
+{
+    const size_t magicSize = strlen(IR_FORMAT_MAGIC);
+
+    if (size < magicSize || memcmp(data, IR_FORMAT_MAGIC, magicSize) != 0)
+    {
+        failed = true;
+        return;
+    }
+
+    current += magicSize;
+
+    unsigned long version;
+    read(version);
+
+    if (version != IR_FORMAT_VERSION)
+        failed = true;
+
+    unsigned long stringsCount;
+
+    if (!readCount(stringsCount))
+        return;
+
+    strings.resize(stringsCount);
+
+    for (std::string& str : strings)
+    {
+        unsigned long length;
+
+        if (!readCount(length))
+            return;
+
+        str.assign(current, length);
+        current += length;
+    }
+}
+
+bool IRReader::readBytes(void* bytes, size_t size)
+{
+    if (failed || (size_t)(end - current) < size)
+    {
+        failed = true;
+        memset(bytes, 0, size);
+        return false;
+    }
+
+    memcpy(bytes, current, size);
+    current += size;
+
+    return true;
+}
+
+bool IRReader::readCount(unsigned long& count)
+{
+    /* Every item takes at least one byte, so a count larger than what is left is invalid */
+
+    read(count);
+
+    if ((unsigned long)(end - current) < count)
+        failed = true;
+
+    if (failed)
+        count = 0;
+
+    return !failed;
+}
+
+void IRReader::read(unsigned long& value)
+{
+    value = 0;
+
+    for (unsigned int shift = 0; shift < sizeof(unsigned long) * 8; shift += 7)
+    {
+        if (failed || current == end)
+            break;
+
+        const unsigned char byte = *current;
+        current += 1;
+
+        value |= (unsigned long)(byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0)
+            return;
+    }
+
+    failed = true;
+    value = 0;
+}
+
+void IRReader::read(unsigned int& value)
+{
+    unsigned long longValue;
+    read(longValue);
+    value = (unsigned int)longValue;
+}
+
+void IRReader::read(long& value)
+{
+    unsigned long encodedValue;
+    read(encodedValue);
+    value = (long)(encodedValue >> 1) ^ -(long)(encodedValue & 1);
+}
+
+void IRReader::read(int& value)
+{
+    long longValue;
+    read(longValue);
+    value = (int)longValue;
+}
+
+void IRReader::read(double& value)
+{
+    readBytes(&value, sizeof(value));
+}
+
+void IRReader::read(std::string& str)
+{
+    unsigned long index;
+    read(index);
+
+    if (index >= strings.size())
+        failed = true;
+
+    if (failed)
+    {
+        str.clear();
+        return;
+    }
+
+    str = strings[index];
+}
+
+void IRReader::read(icode::TypeDescription& type)
+{
+    readEnum(type.dtype);
+    read(type.dtypeName);
+    read(type.moduleName);
+    read(type.dtypeSize);
+    read(type.offset);
+    read(type.size);
+    read(type.dimensions);
+
+    unsigned long dimTypesCount;
+    readCount(dimTypesCount);
+
+    type.dimTypes.resize(dimTypesCount);
+
+    for (icode::DimensionType& dimType : type.dimTypes)
+        readEnum(dimType);
+
+    read(type.properties);
+}
+
+void IRReader::read(icode::Operand& op)
+{
+    readEnum(op.operandType);
+    read(op.operandId);
+    readEnum(op.dtype);
+
+    std::string name;
+    read(name);
+    op.name = icode::internSymbol(name);
+
+    if (op.operandType == icode::LITERAL || op.operandType == icode::BYTES || op.operandType == icode::STR_DATA)
+        readBytes(&op.val, sizeof(op.val));
+    else
+        op.val.bytes = 0;
+}
+
+void IRReader::read(icode::Entry& entry)
+{
+    readEnum(entry.opcode);
+    read(entry.op1);
+    read(entry.op2);
+    read(entry.op3);
+}
+
+void IRReader::read(icode::FunctionDescription& function)
+{
+    read(function.functionReturnType);
+    read(function.parameters);
+    read(function.symbols);
+    read(function.icodeTable);
+    read(function.moduleName);
+    read(function.absoluteName);
+}
+
+void IRReader::read(icode::StructDescription& structDescription)
+{
+    read(structDescription.structFields);
+    read(structDescription.size);
+    read(structDescription.moduleName);
+    read(structDescription.fieldNames);
+    read(structDescription.deconstructor);
+}
+
+void IRReader::read(icode::EnumDescription& enumDescription)
+{
+    read(enumDescription.dtypeName);
+    read(enumDescription.value);
+    read(enumDescription.moduleName);
+}
+
+void IRReader::read(icode::ModuleDescription& module)
+{
+    read(module.name);
+    read(module.uses);
+    read(module.aliases);
+    read(module.incompleteTypes);
+    read(module.structures);
+    read(module.definedFunctions);
+    read(module.incompleteFunctions);
+    read(module.functions);
+    read(module.externFunctions);
+    read(module.definedEnumsTypes);
+    read(module.enums);
+    read(module.intDefines);
+    read(module.floatDefines);
+    read(module.globals);
+    read(module.stringDefines);
+    read(module.stringsData);
+    read(module.stringsDataCharCounts);
+    read(module.hookFunctions);
+    read(module.functionsByReturnType);
+
+    unsigned long mangledNamesCount;
+    readCount(mangledNamesCount);
+
+    module.mangledNames.clear();
+
+    for (unsigned long i = 0; i < mangledNamesCount && !failed; i += 1)
+    {
+        std::string name;
+        std::string mangledName;
+
+        read(name);
+        read(mangledName);
+
+        module.mangledNames[name] = icode::internSymbol(mangledName);
+    }
+}
+
+bool IRReader::hasFailed() const
+{
+    return failed;
+}
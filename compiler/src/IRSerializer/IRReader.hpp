@@ -0,0 +1,94 @@
+#ifndef IR_SERIALIZER_IR_READER
+#define IR_SERIALIZER_IR_READER
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../IntermediateRepresentation/All.hpp"
+
+class IRReader
+{
+    const char* current;
+    const char* end;
+
+    std::vector<std::string> strings;
+
+    bool failed;
+
+    bool readBytes(void* bytes, size_t size);
+    bool readCount(unsigned long& count);
+
+    template <class T>
+    void readEnum(T& value)
+    {
+        unsigned long longValue;
+        read(longValue);
+        value = (T)longValue;
+    }
+
+public:
+    IRReader(const char* data, size_t size);
+
+    void read(unsigned long& value);
+    void read(unsigned int& value);
+    void read(long& value);
+    void read(int& value);
+    void read(double& value);
+    void read(std::string& str);
+    void read(icode::TypeDescription& type);
+    void read(icode::Operand& op);
+    void read(icode::Entry& entry);
+    void read(icode::FunctionDescription& function);
+    void read(icode::StructDescription& structDescription);
+    void read(icode::EnumDescription& enumDescription);
+    void read(icode::ModuleDescription& module);
+
+    template <class T>
+    void read(std::vector<T>& vector)
+    {
+        unsigned long count;
+        readCount(count);
+
+        vector.resize(count);
+
+        for (T& item : vector)
+            read(item);
+    }
+
+    template <class V>
+    void read(std::map<std::string, V>& map)
+    {
+        unsigned long count;
+        readCount(count);
+
+        map.clear();
+
+        for (unsigned long i = 0; i < count && !failed; i += 1)
+        {
+            std::string key;
+            read(key);
+            read(map[key]);
+        }
+    }
+
+    template <class V>
+    void read(icode::SymbolTable<V>& map)
+    {
+        unsigned long count;
+        readCount(count);
+
+        map.clear();
+
+        for (unsigned long i = 0; i < count && !failed; i += 1)
+        {
+            std::string key;
+            read(key);
+            read(map[key]);
+        }
+    }
+
+    bool hasFailed() const;
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include <cstring>
+
+#include "IRFormat.hpp"
+
+#include "IRWriter.hpp"
+
+void IRWriter::writeBytes(const void* bytes, size_t size)
+{
+    body.append((const char*)bytes, size);
+}
+
+void IRWriter::write(unsigned long value)
+{
+    /* Variable length encoding, seven bits per byte, high bit set if more bytes follow */
+
+    while (value >= 0x80)
+    {
+        body.push_back((char)((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+
+    body.push_back((char)value);
+}
+
+void IRWriter::write(unsigned int value)
+{
+    write((unsigned long)value);
+}
+
+void IRWriter::write(long value)
+{
+    /* Zigzag encoding so small negative numbers also take few bytes */
+    write(((unsigned long)value << 1) ^ (unsigned long)(value >> (sizeof(long) * 8 - 1)));
+}
+
+void IRWriter::write(int value)
+{
+    write((long)value);
+}
+
+void IRWriter::write(double value)
+{
+    writeBytes(&value, sizeof(value));
+}
+
+void IRWriter::write(const std::string& str)
+{
+    /* Strings are written once to the string table and referred to by index,
+        module names and type names repeat a lot in the IR */
+
+    auto stringIndexPair = stringIndices.find(str);
+
+    if (stringIndexPair != stringIndices.end())
+    {
+        write(stringIndexPair->second);
+        return;
+    }
+
+    const unsigned long index = strings.size();
+
+    stringIndices[str] = index;
+    strings.push_back(str);
+
+    write(index);
+}
+
+void IRWriter::write(const icode::TypeDescription& type)
+{
+    write((unsigned long)type.dtype);
+    write(type.dtypeName);
+    write(type.moduleName);
+    write(type.dtypeSize);
+    write(type.offset);
+    write(type.size);
+    write(type.dimensions);
+
+    write((unsigned long)type.dimTypes.size());
+
+    for (const icode::DimensionType dimType : type.dimTypes)
+        write((unsigned long)dimType);
+
+    write(type.properties);
+}
+
+void IRWriter::write(const icode::Operand& op)
+{
+    write((unsigned long)op.operandType);
+    write(op.operandId);
+    write((unsigned long)op.dtype);
+    write(icode::symbolName(op.name));
+
+    /* The value union is only initialized for these operands */
+    if (op.operandType == icode::LITERAL || op.operandType == icode::BYTES || op.operandType == icode::STR_DATA)
+        writeBytes(&op.val, sizeof(op.val));
+}
+
+void IRWriter::write(const icode::Entry& entry)
+{
+    write((unsigned long)entry.opcode);
+    write(entry.op1);
+    write(entry.op2);
+    write(entry.op3);
+}
+
+void IRWriter::write(const icode::FunctionDescription& function)
+{
+    write(function.functionReturnType);
+    write(function.parameters);
+    write(function.symbols);
+    write(function.icodeTable);
+    write(function.moduleName);
+    write(function.absoluteName);
+}
+
+void IRWriter::write(const icode::StructDescription& structDescription)
+{
+    write(structDescription.structFields);
+    write(structDescription.size);
+    write(structDescription.moduleName);
+    write(structDescription.fieldNames);
+    write(structDescription.deconstructor);
+}
+
+void IRWriter::write(const icode::EnumDescription& enumDescription)
+{
+    write(enumDescription.dtypeName);
+    write(enumDescription.value);
+    write(enumDescription.moduleName);
+}
+
+void IRWriter::write(const icode::ModuleDescription& module)
+{
+    write(module.name);
+    write(module.uses);
+    write(module.aliases);
+    write(module.incompleteTypes);
+    write(module.structures);
+    write(module.definedFunctions);
+    write(module.incompleteFunctions);
+    write(module.functions);
+    write(module.externFunctions);
+    write(module.definedEnumsTypes);
+    write(module.enums);
+    write(module.intDefines);
+    write(module.floatDefines);
+    write(module.globals);
+    write(module.stringDefines);
+    write(module.stringsData);
+    write(module.stringsDataCharCounts);
+    write(module.hookFunctions);
+    write(module.functionsByReturnType);
+
+    /* Symbol ids are only valid in this process, the mangled names are written as strings */
+    write((unsigned long)module.mangledNames.size());
+
+    for (const auto& pair : module.mangledNames)
+    {
+        write(pair.first);
+        write(icode::symbolName(pair.second));
+    }
+}
+
+std::string IRWriter::getBuffer() const
+{
+    /* The string table is written before the body so the reader
+        has all strings when it starts reading the body */
+
+    IRWriter header;
+
+    header.writeBytes(IR_FORMAT_MAGIC, strlen(IR_FORMAT_MAGIC));
+    header.write((unsigned long)IR_FORMAT_VERSION);
+    header.write((unsigned long)strings.size());
+
+    for (const std::string& str : strings)
+    {
+        header.write((unsigned long)str.size());
+        header.writeBytes(str.data(), str.size());
+    }
+
+    return header.body + body;
+}
@@ -0,0 +1,70 @@
+#ifndef IR_SERIALIZER_IR_WRITER
+#define IR_SERIALIZER_IR_WRITER
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../IntermediateRepresentation/All.hpp"
+
+class IRWriter
+{
+    std::string body;
+
+    std::map<std::string, unsigned long> stringIndices;
+    std::vector<std::string> strings;
+
+    void writeBytes(const void* bytes, size_t size);
+
+public:
+    void write(unsigned long value);
+    void write(unsigned int value);
+    void write(long value);
+    void write(int value);
+    void write(double value);
+    void write(const std::string& str);
+    void write(const icode::TypeDescription& type);
+    void write(const icode::Operand& op);
+    void write(const icode::Entry& entry);
+    void write(const icode::FunctionDescription& function);
+    void write(const icode::StructDescription& structDescription);
+    void write(const icode::EnumDescription& enumDescription);
+    void write(const icode::ModuleDescription& module);
+
+    template <class T>
+    void write(const std::vector<T>& vector)
+    {
+        write((unsigned long)vector.size());
+
+        for (const T& item : vector)
+            write(item);
+    }
+
+    template <class V>
+    void write(const std::map<std::string, V>& map)
+    {
+        write((unsigned long)map.size());
+
+        for (const auto& pair : map)
+        {
+            write(pair.first);
+            write(pair.second);
+        }
+    }
+
+    template <class V>
+    void write(const icode::SymbolTable<V>& map)
+    {
+        write((unsigned long)map.size());
+
+        for (const auto& pair : map)
+        {
+            write(pair.first);
+            write(pair.second);
+        }
+    }
+
+    std::string getBuffer() const;
+};
+
+#endif
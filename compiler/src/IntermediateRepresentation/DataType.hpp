@@ -1,11 +1,12 @@
 #ifndef IR_DATA_TYPE
 #define IR_DATA_TYPE
 
+#include <cstdint>
 #include <string>
 
 namespace icode
 {
-    enum DataType
+    enum DataType : uint8_t
     {
         I8,
         UI8,
@@ -1,11 +1,13 @@
 #ifndef IR_ENTRY
 #define IR_ENTRY
 
+#include <cstdint>
+
 #include "Operand.hpp"
 
 namespace icode
 {
-    enum Instruction
+    enum Instruction : uint8_t
     {
         PASS,
         PASS_PTR,
@@ -1,19 +1,15 @@
-#include "../Utils/GetMapElement.hpp"
-#include "../Utils/ItemInList.hpp"
-#include "../Utils/KeyExistsInMap.hpp"
-
 #include "FunctionDescription.hpp"
 
 namespace icode
 {
     bool FunctionDescription::symbolExists(const std::string& name)
     {
-        return keyExistsInMap(symbols, name);
+        return symbols.count(name) != 0;
     }
 
     bool FunctionDescription::getSymbol(const std::string& name, TypeDescription& returnValue)
     {
-        return getMapElement<std::string, TypeDescription>(symbols, name, returnValue);
+        return symbols.get(name, returnValue);
     }
 
     size_t FunctionDescription::numParameters() const
@@ -26,12 +22,12 @@ namespace icode
         return functionReturnType.dtype == VOID;
     }
 
-    TypeDescription FunctionDescription::getParamType(const std::string& paramName) const
+    const TypeDescription& FunctionDescription::getParamType(const std::string& paramName) const
     {
         return symbols.at(paramName);
     }
 
-    TypeDescription FunctionDescription::getParamTypePos(size_t paramPos) const
+    const TypeDescription& FunctionDescription::getParamTypePos(size_t paramPos) const
     {
         return symbols.at(parameters.at(paramPos));
     }
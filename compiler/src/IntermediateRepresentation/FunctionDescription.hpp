@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "Entry.hpp"
+#include "SymbolTable.hpp"
 #include "TypeDescription.hpp"
 
 namespace icode
@@ -13,7 +14,7 @@ namespace icode
     {
         TypeDescription functionReturnType;
         std::vector<std::string> parameters;
-        std::map<std::string, TypeDescription> symbols;
+        SymbolTable<TypeDescription> symbols;
         std::vector<icode::Entry> icodeTable;
         std::string moduleName; 
         std::string absoluteName;
@@ -22,8 +23,8 @@ namespace icode
         bool getSymbol(const std::string& name, icode::TypeDescription& returnValue);
         size_t numParameters() const;
         bool isVoid() const;
-        TypeDescription getParamType(const std::string& paramName) const;
-        TypeDescription getParamTypePos(size_t paramPos) const;
+        const TypeDescription& getParamType(const std::string& paramName) const;
+        const TypeDescription& getParamTypePos(size_t paramPos) const;
     };
 }
 
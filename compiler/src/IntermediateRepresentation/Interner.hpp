@@ -0,0 +1,153 @@
+#ifndef IR_INTERNER
+#define IR_INTERNER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "ProbingSlots.hpp"
+
+namespace icode
+{
+    /* Gives each distinct value a 32 bit id, shared by all modules and threads. Values are looked up by
+        anything Hash and Equal accept, so a name can be found by a string_view without copying it. Ids are
+        handed out in order and the default value T() always gets id 0. An interner holds its values until
+        reset, which is only safe when no id is held anywhere and no other thread interns */
+    template <class T, class Hash, class Equal, int ChunkBits>
+    class Interner
+    {
+        /* Values are stored in fixed size chunks so references returned by get() stay valid and reading
+            a value takes no lock, a chunk is published before any id in it is handed out */
+        static constexpr size_t CHUNK_SIZE = 1 << ChunkBits;
+        static constexpr size_t MAX_CHUNKS = 4096;
+
+        std::atomic<T*> chunks[MAX_CHUNKS];
+        std::vector<std::unique_ptr<T[]>> ownedChunks;
+
+        std::shared_mutex mutex;
+
+        uint32_t valuesCount;
+        std::vector<size_t> hashes;
+        ProbingSlots<uint32_t> slots;
+
+        T& stored(uint32_t id)
+        {
+            return chunks[id >> ChunkBits].load(std::memory_order_acquire)[id & (CHUNK_SIZE - 1)];
+        }
+
+        template <class K>
+        void store(uint32_t id, const K& value)
+        {
+            const size_t chunk = id >> ChunkBits;
+
+            if (chunk >= MAX_CHUNKS)
+                throw std::length_error("Interner is full");
+
+            if (chunks[chunk].load(std::memory_order_relaxed) == nullptr)
+            {
+                ownedChunks.emplace_back(new T[CHUNK_SIZE]);
+                chunks[chunk].store(ownedChunks.back().get(), std::memory_order_release);
+            }
+
+            stored(id) = value;
+        }
+
+        template <class K>
+        size_t probe(const K& value, size_t hash)
+        {
+            return slots.probe(hash, [&](uint32_t id) { return hashes[id] == hash && Equal()(stored(id), value); });
+        }
+
+        template <class K>
+        bool find(const K& value, size_t hash, uint32_t& returnValue)
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+
+            const size_t position = probe(value, hash);
+
+            if (slots.isEmpty(position))
+                return false;
+
+            returnValue = slots.indexAt(position);
+            return true;
+        }
+
+    public:
+        Interner()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            {
+                std::unique_lock<std::shared_mutex> lock(mutex);
+
+                for (std::atomic<T*>& chunk : chunks)
+                    chunk.store(nullptr, std::memory_order_relaxed);
+
+                ownedChunks.clear();
+                valuesCount = 0;
+                std::vector<size_t>().swap(hashes);
+                slots.reset(1024);
+            }
+
+            intern(T());
+        }
+
+        template <class K>
+        bool find(const K& value, uint32_t& returnValue)
+        {
+            return find(value, Hash()(value), returnValue);
+        }
+
+        template <class K>
+        uint32_t intern(const K& value)
+        {
+            const size_t hash = Hash()(value);
+
+            uint32_t id;
+
+            if (find(value, hash, id))
+                return id;
+
+            std::unique_lock<std::shared_mutex> lock(mutex);
+
+            /* Another thread might have interned the value after find released the lock */
+            const size_t position = probe(value, hash);
+
+            if (!slots.isEmpty(position))
+                return slots.indexAt(position);
+
+            id = valuesCount;
+
+            store(id, value);
+            hashes.push_back(hash);
+            slots.fill(position, id);
+            valuesCount += 1;
+
+            if ((size_t)valuesCount * 2 > slots.size())
+                slots.grow(0, [this](uint32_t index) { return hashes[index]; });
+
+            return id;
+        }
+
+        const T& get(uint32_t id)
+        {
+            return stored(id);
+        }
+
+        size_t count()
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return valuesCount;
+        }
+    };
+}
+
+#endif
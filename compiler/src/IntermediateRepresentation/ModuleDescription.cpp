@@ -1,9 +1,7 @@
 #include <algorithm>
 #include <cmath>
 
-#include "../Utils/GetMapElement.hpp"
 #include "../Utils/ItemInList.hpp"
-#include "../Utils/KeyExistsInMap.hpp"
 
 #include "ModuleDescription.hpp"
 
@@ -18,62 +16,104 @@ namespace icode
 
     bool ModuleDescription::getModuleNameFromAlias(const std::string& alias, std::string& returnValue)
     {
-        return getMapElement<std::string, std::string>(aliases, alias, returnValue);
+        return aliases.get(alias, returnValue);
     }
 
-    bool ModuleDescription::getStruct(const std::string& name, StructDescription& returnValue)
+    bool ModuleDescription::getStruct(const std::string& name, const StructDescription*& returnValue) const
     {
-        return getMapElement<std::string, StructDescription>(structures, name, returnValue);
+        return structures.get(name, returnValue);
     }
 
-    bool ModuleDescription::getFunction(const std::string& name, FunctionDescription& returnValue)
+    bool ModuleDescription::getFunction(const std::string& name, const FunctionDescription*& returnValue) const
     {
-        return getMapElement<std::string, FunctionDescription>(functions, name, returnValue);
+        return functions.get(name, returnValue);
     }
 
-    bool ModuleDescription::getExternFunction(const std::string& name, FunctionDescription& returnValue)
+    bool ModuleDescription::getExternFunction(const std::string& name,
+                                              const FunctionDescription*& returnValue) const
     {
-        return getMapElement<std::string, FunctionDescription>(externFunctions, name, returnValue);
+        return externFunctions.get(name, returnValue);
+    }
+
+    bool ModuleDescription::getFunction(SymbolId name, const FunctionDescription*& returnValue) const
+    {
+        return functions.get(name, returnValue);
+    }
+
+    bool ModuleDescription::getExternFunction(SymbolId name, const FunctionDescription*& returnValue) const
+    {
+        return externFunctions.get(name, returnValue);
+    }
+
+    bool ModuleDescription::getDefinedFunction(const std::string& declaredName,
+                                               const FunctionDescription*& returnValue) const
+    {
+        SymbolId mangledName;
+
+        if (!mangledNames.get(declaredName, mangledName))
+            return false;
+
+        auto pair = functions.find(mangledName);
+
+        if (pair == functions.end())
+            return false;
+
+        returnValue = &pair->second;
+        return true;
+    }
+
+    bool ModuleDescription::getDefinedGlobal(const std::string& declaredName, SymbolId& returnValue) const
+    {
+        SymbolId mangledName;
+
+        if (!mangledNames.get(declaredName, mangledName))
+            return false;
+
+        if (globals.find(mangledName) == globals.end())
+            return false;
+
+        returnValue = mangledName;
+        return true;
     }
 
     bool ModuleDescription::getEnum(const std::string& name, EnumDescription& returnValue)
     {
-        return getMapElement<std::string, EnumDescription>(enums, name, returnValue);
+        return enums.get(name, returnValue);
     }
 
     bool ModuleDescription::getIntDefine(const std::string& name, long& returnValue)
     {
-        return getMapElement<std::string, long>(intDefines, name, returnValue);
+        return intDefines.get(name, returnValue);
     }
 
     bool ModuleDescription::getFloatDefine(const std::string& name, double& returnValue)
     {
-        return getMapElement<std::string, double>(floatDefines, name, returnValue);
+        return floatDefines.get(name, returnValue);
     }
 
     bool ModuleDescription::getStringDefine(const std::string& name, std::string& returnValue)
     {
-        return getMapElement<std::string, std::string>(stringDefines, name, returnValue);
+        return stringDefines.get(name, returnValue);
     }
 
     bool ModuleDescription::getGlobal(const std::string& name, TypeDescription& returnValue)
     {
-        return getMapElement<std::string, TypeDescription>(globals, name, returnValue);
+        return globals.get(name, returnValue);
     }
 
     bool ModuleDescription::getIncompleteTypeModule(const std::string& typeName, std::string& returnValue)
     {
-        return getMapElement<std::string, std::string>(incompleteTypes, typeName, returnValue);
+        return incompleteTypes.get(typeName, returnValue);
     }
 
     bool ModuleDescription::getIncompleteFunctionModule(const std::string& typeName, std::string& returnValue)
     {
-        return getMapElement<std::string, std::string>(incompleteFunctions, typeName, returnValue);
+        return incompleteFunctions.get(typeName, returnValue);
     }
 
     bool ModuleDescription::enumTypeExists(const std::string& name) const
     {
-        return keyExistsInMap(definedEnumsTypes, name);
+        return definedEnumsTypes.count(name) != 0;
     }
 
     bool ModuleDescription::useExists(const std::string& name) const
@@ -83,19 +123,19 @@ namespace icode
 
     bool ModuleDescription::aliasExists(const std::string& name) const
     {
-        return keyExistsInMap(aliases, name);
+        return aliases.count(name) != 0;
     }
 
     bool ModuleDescription::functionExists(const std::string& name) const
     {
-        return keyExistsInMap(functions, name);
+        return functions.count(name) != 0;
     }
 
     bool ModuleDescription::symbolExists(const std::string& name) const
     {
-        return keyExistsInMap(structures, name) || keyExistsInMap(functions, name) || enumTypeExists(name) ||
-               stringToDataType(name) != STRUCT || keyExistsInMap(enums, name) || keyExistsInMap(globals, name) ||
-               keyExistsInMap(intDefines, name) || keyExistsInMap(floatDefines, name) ||
-               keyExistsInMap(stringDefines, name) || keyExistsInMap(externFunctions, name);
+        return structures.count(name) != 0 || functions.count(name) != 0 || enumTypeExists(name) ||
+               stringToDataType(name) != STRUCT || enums.count(name) != 0 || globals.count(name) != 0 ||
+               intDefines.count(name) != 0 || floatDefines.count(name) != 0 ||
+               stringDefines.count(name) != 0 || externFunctions.count(name) != 0;
     }
 }
\ No newline at end of file
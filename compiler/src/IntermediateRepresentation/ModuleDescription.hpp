@@ -8,6 +8,7 @@
 #include "EnumDescription.hpp"
 #include "FunctionDescription.hpp"
 #include "StructDescription.hpp"
+#include "SymbolTable.hpp"
 
 namespace icode
 {
@@ -15,32 +16,49 @@ namespace icode
     {
         std::string name;
         std::vector<std::string> uses;
-        std::map<std::string, std::string> aliases;
+        SymbolTable<std::string> aliases;
 
-        std::map<std::string, std::string> incompleteTypes;
-        std::map<std::string, StructDescription> structures;
+        SymbolTable<std::string> incompleteTypes;
+        SymbolTable<StructDescription> structures;
 
         std::vector<std::string> definedFunctions;
-        std::map<std::string, std::string> incompleteFunctions;
-        std::map<std::string, FunctionDescription> functions;
-        std::map<std::string, FunctionDescription> externFunctions;
+        SymbolTable<std::string> incompleteFunctions;
+        SymbolTable<FunctionDescription> functions;
+        SymbolTable<FunctionDescription> externFunctions;
 
-        std::map<std::string, std::string> definedEnumsTypes;
-        std::map<std::string, EnumDescription> enums;
-        std::map<std::string, long> intDefines;
-        std::map<std::string, double> floatDefines;
-        std::map<std::string, TypeDescription> globals;
+        SymbolTable<std::string> definedEnumsTypes;
+        SymbolTable<EnumDescription> enums;
+        SymbolTable<long> intDefines;
+        SymbolTable<double> floatDefines;
+        SymbolTable<TypeDescription> globals;
 
-        std::map<std::string, std::string> stringDefines;
-        std::map<std::string, std::string> stringsData;
-        std::map<std::string, int> stringsDataCharCounts;
+        SymbolTable<std::string> stringDefines;
+        SymbolTable<std::string> stringsData;
+        SymbolTable<int> stringsDataCharCounts;
+
+        /* Mangled names of the functions and globals defined in this module by the name they are
+            declared with, so lookups do not mangle the name again */
+        SymbolTable<SymbolId> mangledNames;
+
+        /* Mangled names of the operator hooks defined in this module, in the order they are defined, by
+            each prefix of their name that ends before an upper case letter. __addArray__ is listed under
+            __add and __addArray, so the + operator finds it without scanning every function */
+        SymbolTable<std::vector<std::string>> hookFunctions;
+
+        /* Mangled names of the functions defined in this module by the name of their return type,
+            in the order they are defined, make() looks up constructors here */
+        SymbolTable<std::vector<std::string>> functionsByReturnType;
 
         ModuleDescription();
 
         bool getModuleNameFromAlias(const std::string& name, std::string& returnValue);
-        bool getStruct(const std::string& name, StructDescription& returnValue);
-        bool getFunction(const std::string& name, FunctionDescription& returnValue);
-        bool getExternFunction(const std::string& name, FunctionDescription& returnValue);
+        bool getStruct(const std::string& name, const StructDescription*& returnValue) const;
+        bool getFunction(const std::string& name, const FunctionDescription*& returnValue) const;
+        bool getExternFunction(const std::string& name, const FunctionDescription*& returnValue) const;
+        bool getFunction(SymbolId name, const FunctionDescription*& returnValue) const;
+        bool getExternFunction(SymbolId name, const FunctionDescription*& returnValue) const;
+        bool getDefinedFunction(const std::string& declaredName, const FunctionDescription*& returnValue) const;
+        bool getDefinedGlobal(const std::string& declaredName, SymbolId& returnValue) const;
         bool getEnum(const std::string& name, EnumDescription& returnValue);
         bool getIntDefine(const std::string& name, long& returnValue);
         bool getFloatDefine(const std::string& name, double& returnValue);
@@ -0,0 +1,150 @@
+#include <map>
+#include <vector>
+
+#include "ModuleReferences.hpp"
+
+namespace icode
+{
+    void addTypeModule(const TypeDescription& type, std::set<std::string>& referencedModules)
+    {
+        referencedModules.insert(type.moduleName);
+    }
+
+    void addFunctionModules(const FunctionDescription& function, std::set<std::string>& referencedModules)
+    {
+        addTypeModule(function.functionReturnType, referencedModules);
+        referencedModules.insert(function.moduleName);
+
+        for (const auto& symbol : function.symbols)
+            addTypeModule(symbol.second, referencedModules);
+
+        for (const Entry& e : function.icodeTable)
+            if (e.op3.operandType == MODULE)
+                referencedModules.insert(symbolName(e.op3.name));
+    }
+
+    std::set<std::string> getReferencedModules(const ModuleDescription& module)
+    {
+        /* Modules the translator might read from while translating this module */
+
+        std::set<std::string> referencedModules(module.uses.begin(), module.uses.end());
+
+        for (const auto& structure : module.structures)
+            for (const auto& field : structure.second.structFields)
+                addTypeModule(field.second, referencedModules);
+
+        for (const auto& function : module.functions)
+            addFunctionModules(function.second, referencedModules);
+
+        for (const auto& function : module.externFunctions)
+            addFunctionModules(function.second, referencedModules);
+
+        for (const auto& global : module.globals)
+            addTypeModule(global.second, referencedModules);
+
+        return referencedModules;
+    }
+
+    std::set<std::string> getTransitiveReferencedModules(const StringModulesMap& modulesMap,
+                                                         const std::string& moduleName)
+    {
+        std::set<std::string> visited;
+        std::vector<std::string> stack = { moduleName };
+
+        while (stack.size() != 0)
+        {
+            const std::string currentModuleName = stack.back();
+            stack.pop_back();
+
+            if (visited.count(currentModuleName) != 0)
+                continue;
+
+            auto moduleIterator = modulesMap.find(currentModuleName);
+
+            if (moduleIterator == modulesMap.end())
+                continue;
+
+            visited.insert(currentModuleName);
+
+            for (const std::string& referencedModuleName : getReferencedModules(moduleIterator->second))
+                stack.push_back(referencedModuleName);
+        }
+
+        visited.erase(moduleName);
+
+        return visited;
+    }
+
+    void addStringOwnerModule(const Operand& op,
+                              const std::map<std::string, std::string>& stringOwners,
+                              std::set<std::string>& linkedModules)
+    {
+        if (op.operandType != STR_DATA)
+            return;
+
+        auto stringOwnerPair = stringOwners.find(symbolName(op.name));
+
+        if (stringOwnerPair != stringOwners.end())
+            linkedModules.insert(stringOwnerPair->second);
+    }
+
+    std::set<std::string> getLinkedModules(const ModuleDescription& module,
+                                           const std::map<std::string, std::string>& stringOwners)
+    {
+        /* Modules whose objects are needed to link this module, the modules of called functions and of
+            strings defined in other modules. Uses and types are not enough to tell, instantiated generics
+            use the module of a primitive type argument without needing its object */
+
+        std::set<std::string> linkedModules;
+
+        for (const auto& function : module.functions)
+        {
+            for (const Entry& e : function.second.icodeTable)
+            {
+                if (e.op3.operandType == MODULE)
+                    linkedModules.insert(symbolName(e.op3.name));
+
+                addStringOwnerModule(e.op1, stringOwners, linkedModules);
+                addStringOwnerModule(e.op2, stringOwners, linkedModules);
+                addStringOwnerModule(e.op3, stringOwners, linkedModules);
+            }
+        }
+
+        return linkedModules;
+    }
+
+    std::set<std::string> getTransitiveLinkedModules(const StringModulesMap& modulesMap, const std::string& moduleName)
+    {
+        std::map<std::string, std::string> stringOwners;
+
+        for (const auto& stringModulePair : modulesMap)
+            for (const auto& stringDataPair : stringModulePair.second.stringsData)
+                stringOwners[stringDataPair.first] = stringModulePair.first;
+
+        std::set<std::string> visited;
+        std::vector<std::string> stack = { moduleName };
+
+        while (stack.size() != 0)
+        {
+            const std::string currentModuleName = stack.back();
+            stack.pop_back();
+
+            if (visited.count(currentModuleName) != 0)
+                continue;
+
+            auto moduleIterator = modulesMap.find(currentModuleName);
+
+            if (moduleIterator == modulesMap.end())
+                continue;
+
+            visited.insert(currentModuleName);
+
+            for (const std::string& linkedModuleName : getLinkedModules(moduleIterator->second, stringOwners))
+                stack.push_back(linkedModuleName);
+        }
+
+        visited.erase(moduleName);
+
+        return visited;
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef IR_MODULE_REFERENCES
+#define IR_MODULE_REFERENCES
+
+#include <set>
+#include <string>
+
+#include "ModuleDescription.hpp"
+
+namespace icode
+{
+    std::set<std::string> getReferencedModules(const ModuleDescription& module);
+
+    std::set<std::string> getTransitiveReferencedModules(const StringModulesMap& modulesMap,
+                                                         const std::string& moduleName);
+
+    std::set<std::string> getTransitiveLinkedModules(const StringModulesMap& modulesMap, const std::string& moduleName);
+}
+
+#endif
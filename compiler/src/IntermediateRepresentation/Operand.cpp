@@ -5,6 +5,7 @@ namespace icode
     Operand::Operand()
     {
         operandId = 0;
+        name = EMPTY_SYMBOL;
         dtype = VOID;
         operandType = NONE;
     }
@@ -1,13 +1,16 @@
 #ifndef IR_OPERAND
 #define IR_OPERAND
 
+#include <cstdint>
+
 #include "DataType.hpp"
+#include "Symbol.hpp"
 #include "TypeDescription.hpp"
 
 namespace icode
 {
 
-    enum OperandType
+    enum OperandType : uint8_t
     {
         TEMP,
         TEMP_PTR,
@@ -27,9 +30,12 @@ namespace icode
         NONE,
     };
 
+    /* Operands are kept small since every entry holds three of them, name is the SymbolId of the
+        interned name and EMPTY_SYMBOL for operands without a name, use symbolName to get the string */
     struct Operand
     {
         unsigned int operandId;
+        SymbolId name;
 
         union
         {
@@ -39,7 +45,6 @@ namespace icode
             unsigned long size;
         } val;
 
-        std::string name;
         DataType dtype;
         OperandType operandType;
 
@@ -0,0 +1,115 @@
+#ifndef IR_PROBING_SLOTS
+#define IR_PROBING_SLOTS
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace icode
+{
+    /* Slots of an open addressing hash table with linear probing. The table keeps its items in its own
+        storage by index, a slot holds index + 1 and 0 when empty. The slots do not store hashes, the
+        table gives the hash of an index when the slots are rehashed. The number of slots is a power of
+        two, the table grows them before they are half full */
+    template <class Index>
+    class ProbingSlots
+    {
+        std::vector<Index> slots;
+
+    public:
+        void reset(size_t size)
+        {
+            std::vector<Index>(size, 0).swap(slots);
+        }
+
+        void swap(ProbingSlots& other)
+        {
+            slots.swap(other.slots);
+        }
+
+        size_t size() const
+        {
+            return slots.size();
+        }
+
+        /* Position of the slot of the first index matches() accepts, or of the empty slot it would go in */
+        template <class Matches>
+        size_t probe(size_t hash, const Matches& matches) const
+        {
+            const size_t mask = slots.size() - 1;
+
+            for (size_t i = hash & mask;; i = (i + 1) & mask)
+                if (slots[i] == 0 || matches(slots[i] - 1))
+                    return i;
+        }
+
+        bool isEmpty(size_t position) const
+        {
+            return slots[position] == 0;
+        }
+
+        Index indexAt(size_t position) const
+        {
+            return slots[position] - 1;
+        }
+
+        void fill(size_t position, Index index)
+        {
+            slots[position] = index + 1;
+        }
+
+        void place(Index index, size_t hash)
+        {
+            fill(probe(hash, [](Index) { return false; }), index);
+        }
+
+        /* Doubles the slots, to at least minimumSize */
+        template <class HashOf>
+        void grow(size_t minimumSize, const HashOf& hashOf)
+        {
+            std::vector<Index> oldSlots(std::max(minimumSize, slots.size() * 2), 0);
+            slots.swap(oldSlots);
+
+            for (Index slot : oldSlots)
+                if (slot != 0)
+                    place(slot - 1, hashOf(slot - 1));
+        }
+
+        /* Shifts back the indices probed past the removed slot, so no probe stops at it early */
+        template <class HashOf>
+        void remove(Index index, const HashOf& hashOf)
+        {
+            const size_t mask = slots.size() - 1;
+
+            size_t i = hashOf(index) & mask;
+
+            while (slots[i] != index + 1)
+                i = (i + 1) & mask;
+
+            for (size_t j = (i + 1) & mask; slots[j] != 0; j = (j + 1) & mask)
+            {
+                const size_t ideal = hashOf(slots[j] - 1) & mask;
+
+                const bool idealInRange = i <= j ? (i < ideal && ideal <= j) : (i < ideal || ideal <= j);
+
+                if (idealInRange)
+                    continue;
+
+                slots[i] = slots[j];
+                i = j;
+            }
+
+            slots[i] = 0;
+        }
+
+        template <class Function>
+        void forEach(const Function& function) const
+        {
+            for (Index slot : slots)
+                if (slot != 0)
+                    function(slot - 1);
+        }
+    };
+}
+
+#endif
@@ -1,13 +1,10 @@
-#include "../Utils/GetMapElement.hpp"
-#include "../Utils/KeyExistsInMap.hpp"
-
 #include "StructDescription.hpp"
 
 namespace icode
 {
     bool StructDescription::fieldExists(const std::string& name) const
     {
-        return keyExistsInMap(structFields, name);
+        return structFields.count(name) != 0;
     }
 
     DataType StructDescription::getFirstFieldDataType() const
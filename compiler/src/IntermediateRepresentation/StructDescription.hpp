@@ -4,13 +4,14 @@
 #include <map>
 #include <string>
 
+#include "SymbolTable.hpp"
 #include "TypeDescription.hpp"
 
 namespace icode
 {
     struct StructDescription
     {
-        std::map<std::string, TypeDescription> structFields;
+        SymbolTable<TypeDescription> structFields;
         unsigned int size;
         std::string moduleName;
         std::vector<std::string> fieldNames;
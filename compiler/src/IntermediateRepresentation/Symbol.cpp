@@ -0,0 +1,47 @@
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "Interner.hpp"
+
+#include "Symbol.hpp"
+
+namespace icode
+{
+    typedef Interner<std::string, std::hash<std::string_view>, std::equal_to<>, 12> SymbolInterner;
+
+    static SymbolInterner& getInterner()
+    {
+        static SymbolInterner interner;
+        return interner;
+    }
+
+    SymbolId internSymbol(std::string_view name)
+    {
+        /* Most operands have no name, they get the id without a lookup */
+        if (name.empty())
+            return EMPTY_SYMBOL;
+
+        return getInterner().intern(name);
+    }
+
+    bool findSymbol(std::string_view name, SymbolId& returnValue)
+    {
+        return getInterner().find(name, returnValue);
+    }
+
+    const std::string& symbolName(SymbolId id)
+    {
+        return getInterner().get(id);
+    }
+
+    size_t getSymbolsCount()
+    {
+        return getInterner().count();
+    }
+
+    void resetSymbols()
+    {
+        getInterner().reset();
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef IR_SYMBOL
+#define IR_SYMBOL
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace icode
+{
+    typedef uint32_t SymbolId;
+
+    const SymbolId EMPTY_SYMBOL = 0;
+
+    /* Names of the IR are interned into one Interner (see Interner.hpp), the empty name is EMPTY_SYMBOL */
+
+    SymbolId internSymbol(std::string_view name);
+
+    /* Does not intern, a name that was never interned is not the key of any symbol table */
+    bool findSymbol(std::string_view name, SymbolId& returnValue);
+
+    const std::string& symbolName(SymbolId id);
+
+    size_t getSymbolsCount();
+
+    /* shtkc -serve resets between requests, so the names of old sources are not kept */
+    void resetSymbols();
+}
+
+#endif
@@ -0,0 +1,415 @@
+#ifndef IR_SYMBOL_TABLE
+#define IR_SYMBOL_TABLE
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <initializer_list>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ProbingSlots.hpp"
+#include "Symbol.hpp"
+
+namespace icode
+{
+    /* Map from a name to V, used for the symbol tables of the IR. Names are interned and the table is an
+        open addressing hash table keyed by the symbol id. Entries are kept in a deque so references into
+        the table stay valid when more names are added, and iterating visits them in the order of their
+        names like a std::map. The name order is only sorted on the first iteration after names were
+        added, so building a table is not quadratic. Erased entries are only unlinked, their memory is
+        reused when the table is cleared */
+    template <class V>
+    class SymbolTable
+    {
+    public:
+        typedef std::pair<const std::string, V> value_type;
+
+    private:
+        static constexpr size_t npos = (size_t)-1;
+
+        std::deque<value_type> entries;
+        std::vector<SymbolId> entryIds;
+
+        /* Tables of the modules map are iterated by several workers at once, the first of them sorts */
+        mutable std::vector<size_t> sortedEntries;
+        mutable std::atomic<bool> sortedEntriesValid{ true };
+        mutable std::mutex sortedEntriesMutex;
+
+        ProbingSlots<size_t> slots;
+
+        size_t liveCount = 0;
+
+        static size_t hashId(SymbolId id)
+        {
+            return (id * 0x9E3779B97F4A7C15ULL) >> 32;
+        }
+
+        size_t hashEntry(size_t entry) const
+        {
+            return hashId(entryIds[entry]);
+        }
+
+        size_t findEntry(SymbolId id) const
+        {
+            if (slots.size() == 0)
+                return npos;
+
+            const size_t position =
+                slots.probe(hashId(id), [this, id](size_t entry) { return entryIds[entry] == id; });
+
+            if (slots.isEmpty(position))
+                return npos;
+
+            return slots.indexAt(position);
+        }
+
+        size_t findEntry(const std::string& name) const
+        {
+            SymbolId id;
+
+            if (!findSymbol(name, id))
+                return npos;
+
+            return findEntry(id);
+        }
+
+
+        void sortEntries() const
+        {
+            if (sortedEntriesValid.load(std::memory_order_acquire))
+                return;
+
+            std::lock_guard<std::mutex> lock(sortedEntriesMutex);
+
+            if (sortedEntriesValid.load(std::memory_order_relaxed))
+                return;
+
+            sortedEntries.clear();
+            slots.forEach([this](size_t entry) { sortedEntries.push_back(entry); });
+
+            std::sort(sortedEntries.begin(),
+                      sortedEntries.end(),
+                      [this](size_t a, size_t b) { return entries[a].first < entries[b].first; });
+
+            sortedEntriesValid.store(true, std::memory_order_release);
+        }
+
+        size_t sortedPosition(size_t entry) const
+        {
+            sortEntries();
+
+            auto position = std::lower_bound(sortedEntries.begin(),
+                                             sortedEntries.end(),
+                                             entries[entry].first,
+                                             [this](size_t item, const std::string& name)
+                                             { return entries[item].first < name; });
+
+            return position - sortedEntries.begin();
+        }
+
+        size_t insertEntry(const std::string& name)
+        {
+            const SymbolId id = internSymbol(name);
+            const size_t existingEntry = findEntry(id);
+
+            if (existingEntry != npos)
+                return existingEntry;
+
+            if ((liveCount + 1) * 2 > slots.size())
+                slots.grow(8, [this](size_t entry) { return hashEntry(entry); });
+
+            const size_t entry = entries.size();
+
+            entries.emplace_back(name, V());
+            entryIds.push_back(id);
+            slots.place(entry, hashEntry(entry));
+            sortedEntriesValid.store(false, std::memory_order_relaxed);
+
+            liveCount += 1;
+
+            return entry;
+        }
+
+        void unlinkEntry(size_t entry)
+        {
+            slots.remove(entry, [this](size_t index) { return hashEntry(index); });
+
+            if (sortedEntriesValid.load(std::memory_order_relaxed))
+                sortedEntries.erase(sortedEntries.begin() + sortedPosition(entry));
+
+            entries[entry].second = V();
+
+            liveCount -= 1;
+        }
+
+        template <class Table, class Value>
+        class Iterator
+        {
+            Table* table;
+            size_t position;
+            size_t entry;
+
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Value value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef Value* pointer;
+            typedef Value& reference;
+
+            Iterator(Table* table, size_t position, size_t entry)
+                : table(table)
+                , position(position)
+                , entry(entry)
+            {
+            }
+
+            template <class OtherTable, class OtherValue>
+            Iterator(const Iterator<OtherTable, OtherValue>& other)
+                : table(other.table)
+                , position(other.position)
+                , entry(other.entry)
+            {
+            }
+
+            Value& operator*() const
+            {
+                return table->entries[entry];
+            }
+
+            Value* operator->() const
+            {
+                return &table->entries[entry];
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+            Iterator& operator++()
+            {
+                /* Iterators returned by find do not know their position in name order */
+                if (position == npos)
+                    position = table->sortedPosition(entry);
+
+                position += 1;
+                entry = position < table->sortedEntries.size() ? table->sortedEntries[position] : npos;
+
+                return *this;
+            }
+
+            bool operator==(const Iterator& other) const
+            {
+                return entry == other.entry;
+            }
+
+            bool operator!=(const Iterator& other) const
+            {
+                return entry != other.entry;
+            }
+
+            template <class OtherTable, class OtherValue>
+            friend class Iterator;
+        };
+
+    public:
+        typedef Iterator<SymbolTable, value_type> iterator;
+        typedef Iterator<const SymbolTable, const value_type> const_iterator;
+
+        SymbolTable() = default;
+
+        SymbolTable(std::initializer_list<std::pair<std::string, V>> items)
+        {
+            for (const auto& item : items)
+                (*this)[item.first] = item.second;
+        }
+
+        SymbolTable(const SymbolTable& other)
+            : entries(other.entries)
+            , entryIds(other.entryIds)
+            , slots(other.slots)
+            , liveCount(other.liveCount)
+        {
+            other.sortEntries();
+            sortedEntries = other.sortedEntries;
+        }
+
+        SymbolTable(SymbolTable&& other)
+        {
+            swap(other);
+        }
+
+        SymbolTable& operator=(SymbolTable other)
+        {
+            swap(other);
+            return *this;
+        }
+
+        void swap(SymbolTable& other)
+        {
+            entries.swap(other.entries);
+            entryIds.swap(other.entryIds);
+            sortedEntries.swap(other.sortedEntries);
+            sortedEntriesValid.store(other.sortedEntriesValid.exchange(sortedEntriesValid.load()));
+            slots.swap(other.slots);
+            std::swap(liveCount, other.liveCount);
+        }
+
+        V& operator[](const std::string& name)
+        {
+            return entries[insertEntry(name)].second;
+        }
+
+        V& at(const std::string& name)
+        {
+            const size_t entry = findEntry(name);
+
+            if (entry == npos)
+                throw std::out_of_range("SymbolTable::at");
+
+            return entries[entry].second;
+        }
+
+        const V& at(const std::string& name) const
+        {
+            const size_t entry = findEntry(name);
+
+            if (entry == npos)
+                throw std::out_of_range("SymbolTable::at");
+
+            return entries[entry].second;
+        }
+
+        /* Lookups by symbol id take no lock, use them when the id is at hand */
+
+        const V& at(SymbolId id) const
+        {
+            const size_t entry = findEntry(id);
+
+            if (entry == npos)
+                throw std::out_of_range("SymbolTable::at");
+
+            return entries[entry].second;
+        }
+
+        bool get(SymbolId id, const V*& returnValue) const
+        {
+            const size_t entry = findEntry(id);
+
+            if (entry == npos)
+                return false;
+
+            returnValue = &entries[entry].second;
+            return true;
+        }
+
+        size_t count(SymbolId id) const
+        {
+            return findEntry(id) == npos ? 0 : 1;
+        }
+
+        bool get(const std::string& name, V& returnValue) const
+        {
+            const size_t entry = findEntry(name);
+
+            if (entry == npos)
+                return false;
+
+            returnValue = entries[entry].second;
+            return true;
+        }
+
+        bool get(const std::string& name, const V*& returnValue) const
+        {
+            const size_t entry = findEntry(name);
+
+            if (entry == npos)
+                return false;
+
+            returnValue = &entries[entry].second;
+            return true;
+        }
+
+        iterator find(const std::string& name)
+        {
+            return iterator(this, npos, findEntry(name));
+        }
+
+        const_iterator find(const std::string& name) const
+        {
+            return const_iterator(this, npos, findEntry(name));
+        }
+
+        iterator find(SymbolId id)
+        {
+            return iterator(this, npos, findEntry(id));
+        }
+
+        const_iterator find(SymbolId id) const
+        {
+            return const_iterator(this, npos, findEntry(id));
+        }
+
+        size_t count(const std::string& name) const
+        {
+            return findEntry(name) == npos ? 0 : 1;
+        }
+
+        size_t erase(const std::string& name)
+        {
+            const size_t entry = findEntry(name);
+
+            if (entry == npos)
+                return 0;
+
+            unlinkEntry(entry);
+            return 1;
+        }
+
+        void clear()
+        {
+            *this = SymbolTable();
+        }
+
+        size_t size() const
+        {
+            return liveCount;
+        }
+
+        bool empty() const
+        {
+            return liveCount == 0;
+        }
+
+        iterator begin()
+        {
+            sortEntries();
+            return iterator(this, 0, sortedEntries.empty() ? npos : sortedEntries[0]);
+        }
+
+        iterator end()
+        {
+            return iterator(this, npos, npos);
+        }
+
+        const_iterator begin() const
+        {
+            sortEntries();
+            return const_iterator(this, 0, sortedEntries.empty() ? npos : sortedEntries[0]);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(this, npos, npos);
+        }
+    };
+}
+
+#endif
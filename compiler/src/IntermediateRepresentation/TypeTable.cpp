@@ -0,0 +1,73 @@
+#include <functional>
+#include <string>
+
+#include "Interner.hpp"
+
+#include "TypeTable.hpp"
+
+namespace icode
+{
+    struct TypeDescriptionHash
+    {
+        size_t operator()(const TypeDescription& type) const
+        {
+            size_t hash = std::hash<std::string>()(type.dtypeName) ^ (std::hash<std::string>()(type.moduleName) << 1);
+
+            const auto combine = [&hash](size_t value)
+            { hash ^= value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2); };
+
+            combine(type.dtype);
+            combine(type.dtypeSize);
+            combine(type.offset);
+            combine(type.size);
+            combine(type.properties);
+
+            for (int dimension : type.dimensions)
+                combine(dimension);
+
+            for (DimensionType dimType : type.dimTypes)
+                combine(dimType);
+
+            return hash;
+        }
+    };
+
+    struct TypeDescriptionEqual
+    {
+        bool operator()(const TypeDescription& type1, const TypeDescription& type2) const
+        {
+            return type1.dtype == type2.dtype && type1.dtypeSize == type2.dtypeSize && type1.offset == type2.offset &&
+                   type1.size == type2.size && type1.properties == type2.properties &&
+                   type1.dimensions == type2.dimensions && type1.dimTypes == type2.dimTypes &&
+                   type1.dtypeName == type2.dtypeName && type1.moduleName == type2.moduleName;
+        }
+    };
+
+    typedef Interner<TypeDescription, TypeDescriptionHash, TypeDescriptionEqual, 10> TypeTable;
+
+    static TypeTable& getTypeTable()
+    {
+        static TypeTable typeTable;
+        return typeTable;
+    }
+
+    TypeId internType(const TypeDescription& type)
+    {
+        return getTypeTable().intern(type);
+    }
+
+    const TypeDescription& internedType(TypeId id)
+    {
+        return getTypeTable().get(id);
+    }
+
+    size_t getTypesCount()
+    {
+        return getTypeTable().count();
+    }
+
+    void resetTypes()
+    {
+        getTypeTable().reset();
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef IR_TYPE_TABLE
+#define IR_TYPE_TABLE
+
+#include <cstddef>
+#include <cstdint>
+
+#include "TypeDescription.hpp"
+
+namespace icode
+{
+    typedef uint32_t TypeId;
+
+    /* Types are hash consed into one interner, equal type descriptions get the same id and the
+        description is stored once until the table is reset */
+
+    /* Id of TypeDescription(), the type of empty units */
+    const TypeId EMPTY_TYPE = 0;
+
+    TypeId internType(const TypeDescription& type);
+
+    const TypeDescription& internedType(TypeId id);
+
+    size_t getTypesCount();
+
+    void resetTypes();
+}
+
+#endif
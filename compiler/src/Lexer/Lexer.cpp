@@ -1,46 +1,314 @@
+#include <algorithm>
+#include <array>
+
+#include "../Utils/PhaseTimer.hpp"
+
 #include "Lexer.hpp"
 
-static std::regex identifierRegex(R"([a-zA-Z_][a-zA-Z0-9_]*)");
-static std::regex integerRegex(R"([0-9]+)");
-static std::regex hexRegex(R"(0x[a-fA-f0-9]+)");
-static std::regex binRegex(R"(0b[0-1]+)");
-static std::regex floatRegex(R"([0-9]*\.[0-9]+)");
+/* Character classes used to match the non punctuator tokens, identifiers and number literals */
+
+enum CharClass
+{
+    DIGIT = 1,
+    HEX_DIGIT = 2,
+    BIN_DIGIT = 4,
+    IDENTIFIER_START = 8,
+    IDENTIFIER_CHAR = 16,
+};
+
+constexpr std::array<unsigned char, 256> createCharClassTable()
+{
+    std::array<unsigned char, 256> table = {};
+
+    for (int c = '0'; c <= '9'; c += 1)
+        table[c] |= DIGIT | HEX_DIGIT | IDENTIFIER_CHAR;
+
+    for (int c = 'a'; c <= 'z'; c += 1)
+        table[c] |= IDENTIFIER_START | IDENTIFIER_CHAR;
+
+    for (int c = 'A'; c <= 'Z'; c += 1)
+        table[c] |= IDENTIFIER_START | IDENTIFIER_CHAR;
+
+    for (int c = 'a'; c <= 'f'; c += 1)
+        table[c] |= HEX_DIGIT;
+
+    for (int c = 'A'; c <= 'F'; c += 1)
+        table[c] |= HEX_DIGIT;
+
+    table['0'] |= BIN_DIGIT;
+    table['1'] |= BIN_DIGIT;
+    table['_'] |= IDENTIFIER_START | IDENTIFIER_CHAR;
+
+    return table;
+}
+
+static constexpr std::array<unsigned char, 256> charClassTable = createCharClassTable();
+
+bool isCharClass(char c, CharClass charClass)
+{
+    return charClassTable[(unsigned char)c] & charClass;
+}
+
+bool allCharsOfClass(const char* str, size_t length, CharClass charClass)
+{
+    for (size_t i = 0; i < length; i += 1)
+        if (!isCharClass(str[i], charClass))
+            return false;
+
+    return true;
+}
+
+/* Keywords are looked up in a perfect hash table, the hash function was chosen so no two keywords
+    share a slot, createKeywordTable fails to compile if a keyword is added that collides */
+
+struct Keyword
+{
+    const char* string;
+    token::TokenType type;
+};
+
+static constexpr Keyword keywords[] = {
+    { "use", token::USE },          { "generic", token::GENERIC }, { "as", token::AS },
+    { "from", token::FROM },        { "fn", token::FUNCTION },     { "extfn", token::EXTERN_FUNCTION },
+    { "externC", token::EXTERN_C }, { "struct", token::STRUCT },   { "class", token::STRUCT },
+    { "enum", token::ENUM },        { "def", token::DEF },         { "var", token::VAR },
+    { "const", token::CONST },      { "if", token::IF },           { "else", token::ELSE },
+    { "while", token::WHILE },      { "do", token::DO },           { "for", token::FOR },
+    { "loop", token::LOOP },        { "break", token::BREAK },     { "continue", token::CONTINUE },
+    { "return", token::RETURN },    { "mut", token::MUTABLE },     { "and", token::CONDN_AND },
+    { "or", token::CONDN_OR },      { "not", token::CONDN_NOT },   { "void", token::VOID },
+    { "sizeof", token::SIZEOF },    { "make", token::MAKE },       { "addr", token::ADDR },
+    { "print", token::PRINT },      { "println", token::PRINTLN }, { "in", token::IN },
+};
+
+static constexpr size_t KEYWORD_TABLE_SIZE = 64;
+static constexpr size_t MIN_KEYWORD_LENGTH = 2;
+static constexpr size_t MAX_KEYWORD_LENGTH = 8;
+
+constexpr size_t keywordHash(const char* str, size_t length)
+{
+    return ((unsigned char)str[0] * 11 + (unsigned char)str[1] * 11 + (unsigned char)str[length - 1] * 7 + length) %
+           KEYWORD_TABLE_SIZE;
+}
+
+constexpr std::array<int, KEYWORD_TABLE_SIZE> createKeywordTable()
+{
+    std::array<int, KEYWORD_TABLE_SIZE> table = {};
+
+    for (int& slot : table)
+        slot = -1;
+
+    for (int i = 0; i < (int)(sizeof(keywords) / sizeof(Keyword)); i += 1)
+    {
+        const size_t length = std::char_traits<char>::length(keywords[i].string);
+
+        if (length < MIN_KEYWORD_LENGTH || length > MAX_KEYWORD_LENGTH)
+            throw "Keyword length out of range";
+
+        int& slot = table[keywordHash(keywords[i].string, length)];
+
+        if (slot != -1)
+            throw "Keyword hash collision";
+
+        slot = i;
+    }
+
+    return table;
+}
+
+static constexpr std::array<int, KEYWORD_TABLE_SIZE> keywordTable = createKeywordTable();
+
+bool findKeyword(std::string_view string, token::TokenType& type)
+{
+    if (string.size() < MIN_KEYWORD_LENGTH || string.size() > MAX_KEYWORD_LENGTH)
+        return false;
+
+    const int keywordIndex = keywordTable[keywordHash(string.data(), string.size())];
+
+    if (keywordIndex == -1 || keywords[keywordIndex].string != string)
+        return false;
+
+    type = keywords[keywordIndex].type;
+    return true;
+}
+
+bool isIdentifier(std::string_view string)
+{
+    return isCharClass(string[0], IDENTIFIER_START) &&
+           allCharsOfClass(string.data() + 1, string.size() - 1, IDENTIFIER_CHAR);
+}
+
+token::TokenType numberLiteralType(std::string_view string)
+{
+    /* Matches 0x[0-9a-fA-F]+, 0b[01]+, [0-9]+ and [0-9]*\.[0-9]+ */
+
+    const char* str = string.data();
+    const size_t length = string.size();
+
+    if (length > 2 && str[0] == '0' && str[1] == 'x')
+        return allCharsOfClass(str + 2, length - 2, HEX_DIGIT) ? token::HEX_LITERAL : token::INVALID;
+
+    if (length > 2 && str[0] == '0' && str[1] == 'b')
+        return allCharsOfClass(str + 2, length - 2, BIN_DIGIT) ? token::BIN_LITERAL : token::INVALID;
+
+    size_t i = 0;
+
+    while (i < length && isCharClass(str[i], DIGIT))
+        i += 1;
+
+    if (i == length)
+        return token::INT_LITERAL;
+
+    if (str[i] != '.' || i + 1 == length)
+        return token::INVALID;
+
+    return allCharsOfClass(str + i + 1, length - i - 1, DIGIT) ? token::FLOAT_LITERAL : token::INVALID;
+}
 
 namespace lexer
 {
-    bool readLine(std::ifstream& file, std::string& line)
+    /* Number of lines lexed at once when more tokens are needed, keeps the phase timer out of the
+        hot path */
+    constexpr int LINES_PER_FILL = 64;
+
+    int bracketKind(token::TokenType type)
     {
-        try
-        {
-            getline(file, line);
-            return true;
-        }
-        catch (const std::ifstream::failure& e)
+        /* Index into Lexer::openBrackets */
+
+        switch (type)
         {
-            return false;
+            case token::LPAREN:
+            case token::RPAREN:
+                return 0;
+            case token::OPEN_SQUARE:
+            case token::CLOSE_SQUARE:
+                return 1;
+            case token::OPEN_BRACE:
+            case token::CLOSE_BRACE:
+                return 2;
+            default:
+                return -1;
         }
     }
 
+    bool isOpenBracket(token::TokenType type)
+    {
+        return type == token::LPAREN || type == token::OPEN_SQUARE || type == token::OPEN_BRACE;
+    }
+
     Lexer::Lexer(Console& console)
-        : console(console)
+        : ringStart(0)
+        , ringSize(0)
+        , consumedTokens(0)
+        , source(console.getSource())
+        , lineNo(0)
+        , reachedEnd(false)
+        , console(console)
     {
         fileName = console.getFileName();
-        consume(*console.getStream());
-        getTokenIndex = 0;
+        fileId = source.fileId;
+    }
+
+    void Lexer::pushToken(const Token& token)
+    {
+        if (ringSize == ringBuffer.size())
+        {
+            /* Grow and unwrap the ring buffer */
+            const size_t capacity = std::max(ringBuffer.size() * 2, (size_t)64);
+            std::vector<BufferedToken> grownBuffer(capacity, BufferedToken{ token, 0 });
+
+            for (size_t i = 0; i < ringSize; i++)
+                grownBuffer[i] = bufferedTokenAt(i);
+
+            ringBuffer.swap(grownBuffer);
+            ringStart = 0;
+        }
+
+        ringSize++;
+        bufferedTokenAt(ringSize - 1) = BufferedToken{ token, 0 };
+
+        matchBracket(token.getType());
     }
 
-    void Lexer::consume(std::ifstream& file)
+    void Lexer::matchBracket(token::TokenType type)
     {
-        std::string line;
-        int lineNo = 0;
+        /* Builds the bracket matching table as tokens are lexed, so that matchedBracketPeek does not have to
+            scan and count brackets */
+
+        const int kind = bracketKind(type);
+
+        if (kind == -1)
+            return;
 
-        while (readLine(file, line))
+        const size_t position = consumedTokens + ringSize - 1;
+
+        if (isOpenBracket(type))
+        {
+            openBrackets[kind].push_back(position);
+            return;
+        }
+
+        if (openBrackets[kind].empty())
+            return;
+
+        const size_t openPosition = openBrackets[kind].back();
+        openBrackets[kind].pop_back();
+
+        /* The parser might have consumed the opening bracket already */
+        if (openPosition < consumedTokens)
+            return;
+
+        bufferedTokenAt(openPosition - consumedTokens).matchDistance = position - openPosition;
+    }
+
+    void Lexer::consumeLines()
+    {
+        /* Each line is copied to a buffer with a space at the end for the punctuator matching, the
+            tokens themselves point into the source */
+
+        timer::ScopedPhase phase("Lexing", fileName);
+
+        const int lineCount = source.getLineCount();
+        const int lastLineNo = std::min(lineNo + LINES_PER_FILL, lineCount);
+
+        while (lineNo < lastLineNo)
         {
             lineNo++;
-            consumeLine(line, lineNo);
+
+            const std::string_view sourceLine = source.getLine(lineNo);
+
+            line.assign(sourceLine.data(), sourceLine.size());
+            consumeLine(line, sourceLine.data(), lineNo);
         }
 
-        tokenQueue.push_back(Token(fileName, "", token::END_OF_FILE, line.length(), lineNo));
+        if (lineNo < lineCount)
+            return;
+
+        /* Column of end of file is where std::getline left the last line, past the space added
+            by consumeLine when the file does not end with a new line */
+        const size_t endColumn = source.endsWithNewLine() || lineNo == 0 ? 0 : source.getLine(lineNo).size() + 1;
+
+        pushToken(Token(fileId, std::string_view(), token::END_OF_FILE, endColumn, lineNo));
+        reachedEnd = true;
+    }
+
+    BufferedToken& Lexer::bufferedTokenAt(size_t index)
+    {
+        return ringBuffer[(ringStart + index) & (ringBuffer.size() - 1)];
+    }
+
+    const Token& Lexer::tokenAt(size_t index)
+    {
+        /* Token index positions after the next token to be consumed, END_OF_FILE is returned for
+            positions past the end of the file */
+
+        while (index >= ringSize && !reachedEnd)
+            consumeLines();
+
+        if (index >= ringSize)
+            index = ringSize - 1;
+
+        return bufferedTokenAt(index).token;
     }
 
     LenTypePair Lexer::consumePunctuatorOrStringLtrl(const std::string& line, int lineNo, int i)
@@ -233,71 +501,49 @@ namespace lexer
         }
     }
 
-    token::TokenType Lexer::typeFromStringMatch(const std::string& string)
+    token::TokenType Lexer::typeFromStringMatch(std::string_view string)
     {
-        static std::map<std::string, token::TokenType> stringTypeMap = {
-            { "use", token::USE },          { "generic", token::GENERIC }, { "as", token::AS },
-            { "from", token::FROM },        { "fn", token::FUNCTION },     { "extfn", token::EXTERN_FUNCTION },
-            { "externC", token::EXTERN_C }, { "struct", token::STRUCT },   { "class", token::STRUCT },
-            { "enum", token::ENUM },        { "def", token::DEF },         { "var", token::VAR },
-            { "const", token::CONST },      { "if", token::IF },           { "else", token::ELSE },
-            { "while", token::WHILE },      { "do", token::DO },           { "for", token::FOR },
-            { "loop", token::LOOP },        { "break", token::BREAK },     { "continue", token::CONTINUE },
-            { "return", token::RETURN },    { "mut", token::MUTABLE },     { "and", token::CONDN_AND },
-            { "or", token::CONDN_OR },      { "not", token::CONDN_NOT },   { "void", token::VOID },
-            { "sizeof", token::SIZEOF },    { "make", token::MAKE },       { "addr", token::ADDR },
-            { "print", token::PRINT },      { "println", token::PRINTLN }, { "in", token::IN },
-        };
-
-        auto search = stringTypeMap.find(string);
-
-        if (search != stringTypeMap.end())
-            return search->second;
-
-        if (std::regex_match(string, integerRegex))
-            return token::INT_LITERAL;
-        if (std::regex_match(string, hexRegex))
-            return token::HEX_LITERAL;
-        if (std::regex_match(string, binRegex))
-            return token::BIN_LITERAL;
-        if (std::regex_match(string, floatRegex))
-            return token::FLOAT_LITERAL;
-        if (std::regex_match(string, identifierRegex))
+        token::TokenType keywordType;
+
+        if (findKeyword(string, keywordType))
+            return keywordType;
+
+        if (isIdentifier(string))
             return token::IDENTIFIER;
 
-        return token::INVALID;
+        return numberLiteralType(string);
     }
 
-    bool Lexer::pushPrecedingTokenIfIdentifier(std::string& line, int lineNo, size_t startIndex, size_t i)
+    bool Lexer::pushPrecedingTokenIfIdentifier(const char* lineSource, int lineNo, size_t startIndex, size_t i)
     {
         /* Returns true if it pushed a token::IDENTIFIER type token */
 
         if (startIndex == i)
             return false;
 
-        std::string precedingTokenString = line.substr(startIndex, i - startIndex);
+        std::string_view precedingTokenString(lineSource + startIndex, i - startIndex);
 
-        if (std::regex_match(precedingTokenString, identifierRegex))
+        if (isIdentifier(precedingTokenString))
         {
-            tokenQueue.push_back(Token(fileName, precedingTokenString, token::IDENTIFIER, startIndex, lineNo));
+            pushToken(Token(fileId, precedingTokenString, token::IDENTIFIER, startIndex, lineNo));
             return true;
         }
 
         return false;
     }
 
-    void Lexer::pushPrecedingToken(std::string& line, int lineNo, size_t startIndex, size_t i)
+    void Lexer::pushPrecedingToken(const char* lineSource, int lineNo, size_t startIndex, size_t i)
     {
         if (startIndex == i)
             return;
 
-        std::string precedingTokenString = line.substr(startIndex, i - startIndex);
+        std::string_view precedingTokenString(lineSource + startIndex, i - startIndex);
         token::TokenType precedingTokenType = typeFromStringMatch(precedingTokenString);
 
-        tokenQueue.push_back(Token(fileName, precedingTokenString, precedingTokenType, startIndex, lineNo));
+        pushToken(Token(fileId, precedingTokenString, precedingTokenType, startIndex, lineNo));
     }
 
-    void Lexer::consumeLine(std::string& line, int lineNo)
+    void Lexer::consumeLine(std::string& line, const char* lineSource, int lineNo)
     {
         line += ' '; /* line is not const because of this */
 
@@ -331,22 +577,28 @@ namespace lexer
             if (punctuatorTokenType == token::DOT)
             {
                 /* Push dot token if preceding token is an identifier */
-                if (pushPrecedingTokenIfIdentifier(line, lineNo, startIndex, i) || startIndex == i)
+                if (pushPrecedingTokenIfIdentifier(lineSource, lineNo, startIndex, i) || startIndex == i)
                 {
-                    tokenQueue.push_back(
-                        Token(fileName, line.substr(i, punctuatorTokenLen), punctuatorTokenType, i, lineNo));
+                    pushToken(Token(fileId,
+                                    std::string_view(lineSource + i, punctuatorTokenLen),
+                                    punctuatorTokenType,
+                                    i,
+                                    lineNo));
                     buildingToken = false;
                 }
             }
             else if (punctuatorTokenType != token::NONE)
             {
                 /* PUSH the token preceding the punctuator/space */
-                pushPrecedingToken(line, lineNo, startIndex, i);
+                pushPrecedingToken(lineSource, lineNo, startIndex, i);
 
                 /* Add punctuator token to queue */
                 if (punctuatorTokenType != token::SPACE)
-                    tokenQueue.push_back(
-                        Token(fileName, line.substr(i, punctuatorTokenLen), punctuatorTokenType, i, lineNo));
+                    pushToken(Token(fileId,
+                                    std::string_view(lineSource + i, punctuatorTokenLen),
+                                    punctuatorTokenType,
+                                    i,
+                                    lineNo));
 
                 buildingToken = false;
             }
@@ -357,50 +609,46 @@ namespace lexer
 
     Token Lexer::getToken()
     {
-        /* Return latest token from queue and pop it */
-        return tokenQueue[getTokenIndex++];
+        /* Return latest token and pop it, END_OF_FILE is never popped */
+        const Token token = tokenAt(0);
+
+        if (token.getType() != token::END_OF_FILE)
+        {
+            ringStart = (ringStart + 1) & (ringBuffer.size() - 1);
+            ringSize--;
+            consumedTokens++;
+        }
+
+        return token;
     }
 
-    Token Lexer::peekToken()
+    const Token& Lexer::peekToken()
     {
         /* Return latest token without popping */
-        return tokenQueue[getTokenIndex];
+        return tokenAt(0);
     }
 
-    Token Lexer::doublePeekToken()
+    const Token& Lexer::doublePeekToken()
     {
-        return tokenQueue[getTokenIndex + 1];
+        return tokenAt(1);
     }
 
-    Token Lexer::matchedBracketPeek(token::TokenType open, token::TokenType close)
+    const Token& Lexer::matchedBracketPeek(token::TokenType open)
     {
-        int bracketCounter = 0;
-        int peekCounter = 0;
+        size_t index = 0;
 
-        while (true)
+        while (tokenAt(index).getType() == open)
         {
-            const Token token = tokenQueue[getTokenIndex + peekCounter];
-            peekCounter++;
-
-            if (token.getType() == token::END_OF_FILE)
-                return token;
+            /* Lex until the closing bracket, an unclosed bracket matches END_OF_FILE */
+            while (bufferedTokenAt(index).matchDistance == 0 && !reachedEnd)
+                consumeLines();
 
-            if (token.getType() == open)
-            {
-                bracketCounter++;
-                continue;
-            }
-
-            if (token.getType() == close)
-            {
-                bracketCounter--;
-                continue;
-            }
+            if (bufferedTokenAt(index).matchDistance == 0)
+                return tokenAt(ringSize);
 
-            if (bracketCounter == 0)
-                return token;
+            index += bufferedTokenAt(index).matchDistance + 1;
         }
 
-        console.internalBugError();
+        return tokenAt(index);
     }
 } // namespace lexer
@@ -1,9 +1,9 @@
 #ifndef LEXER_LEXER
 #define LEXER_LEXER
 
-#include <fstream>
-#include <regex>
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../Console/Console.hpp"
@@ -13,27 +13,61 @@ typedef std::pair<int, token::TokenType> LenTypePair;
 
 namespace lexer
 {
+    /* Token in the lexer's ring buffer, an opening bracket stores the number of tokens until its matching
+        closing bracket, zero until the closing bracket is lexed */
+    struct BufferedToken
+    {
+        Token token;
+        unsigned int matchDistance;
+    };
+
     class Lexer
     {
-        std::vector<Token> tokenQueue;
+        /* Tokens are produced on demand a few lines at a time into a ring buffer holding the tokens
+            lexed but not consumed yet. The capacity is a power of two and grows when a peek needs
+            more tokens than it can hold */
+        std::vector<BufferedToken> ringBuffer;
+        size_t ringStart;
+        size_t ringSize;
+        size_t consumedTokens;
+
+        /* Positions of opening brackets not closed yet, counted from the first token of the file,
+            for parentheses, square brackets and braces */
+        std::array<std::vector<size_t>, 3> openBrackets;
+
+        const source::SourceFile& source;
+        std::string line;
+        int lineNo;
+        bool reachedEnd;
+
         std::string fileName;
-        size_t getTokenIndex;
+        unsigned int fileId;
         Console& console;
 
-        void consumeLine(std::string& line, int lineNo);
-        bool pushPrecedingTokenIfIdentifier(std::string& line, int lineNo, size_t startIndex, size_t i);
-        void pushPrecedingToken(std::string& line, int lineNo, size_t startIndex, size_t i);
+        void pushToken(const Token& token);
+        void matchBracket(token::TokenType type);
+        void consumeLines();
+        BufferedToken& bufferedTokenAt(size_t index);
+        const Token& tokenAt(size_t index);
+
+        void consumeLine(std::string& line, const char* lineSource, int lineNo);
+        bool pushPrecedingTokenIfIdentifier(const char* lineSource, int lineNo, size_t startIndex, size_t i);
+        void pushPrecedingToken(const char* lineSource, int lineNo, size_t startIndex, size_t i);
         bool ignoreWhiteSpace(std::string& line, size_t i);
         LenTypePair consumePunctuatorOrStringLtrl(const std::string& line, int lineNo, int i);
-        token::TokenType typeFromStringMatch(const std::string& string);
-        void consume(std::ifstream& file);
+        token::TokenType typeFromStringMatch(std::string_view string);
 
     public:
         Lexer(Console& console);
+
+        /* References returned by the peek functions are valid until the next call to the lexer */
         Token getToken();
-        Token peekToken();
-        Token doublePeekToken();
-        Token matchedBracketPeek(token::TokenType open, token::TokenType close);
+        const Token& peekToken();
+        const Token& doublePeekToken();
+
+        /* Skips the bracket groups starting at the next token and returns the token after them, open must
+            be LPAREN, OPEN_SQUARE or OPEN_BRACE */
+        const Token& matchedBracketPeek(token::TokenType open);
     };
 }
 
@@ -0,0 +1,84 @@
+#include "AST.hpp"
+
+AST::AST()
+    : AST(Node())
+{
+}
+
+AST::AST(const Node& root)
+{
+    arena = std::make_shared<std::vector<Node>>();
+    arena->push_back(root);
+
+    arena->front().children = NodeList();
+    setChildren(0, std::vector<Node>(root.children.begin(), root.children.end()));
+}
+
+const Node& AST::getRoot() const
+{
+    return arena->front();
+}
+
+Node& AST::getNode(uint32_t index)
+{
+    return (*arena)[index];
+}
+
+uint32_t AST::getChildIndex(uint32_t index, size_t N) const
+{
+    return (*arena)[index].children.first + N;
+}
+
+void AST::copyForeignChildren(uint32_t index)
+{
+    const NodeList& children = (*arena)[index].children;
+
+    if (children.arena == arena.get() || children.empty())
+        return;
+
+    setChildren(index, std::vector<Node>(children.begin(), children.end()));
+}
+
+void AST::setChildren(uint32_t index, const std::vector<Node>& children)
+{
+    const uint32_t first = arena->size();
+
+    arena->insert(arena->end(), children.begin(), children.end());
+
+    NodeList& childList = (*arena)[index].children;
+    childList.arena = arena.get();
+    childList.first = first;
+    childList.count = children.size();
+
+    for (uint32_t i = first; i < first + children.size(); i += 1)
+        copyForeignChildren(i);
+}
+
+void AST::reserve(size_t nodeCount)
+{
+    arena->reserve(nodeCount);
+}
+
+AST AST::clone() const
+{
+    /* Nodes are plain values, copying the arena and pointing the child lists to the copy is enough */
+
+    AST copy;
+    copy.arena->reserve(arena->size() + arena->size() / 4);
+    copy.arena->assign(arena->begin(), arena->end());
+
+    for (Node& node : *copy.arena)
+        node.children.arena = copy.arena.get();
+
+    return copy;
+}
+
+size_t AST::getNodeCount() const
+{
+    return arena->size();
+}
+
+size_t AST::getArenaBytes() const
+{
+    return sizeof(std::vector<Node>) + arena->capacity() * sizeof(Node);
+}
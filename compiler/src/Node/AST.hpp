@@ -0,0 +1,39 @@
+#ifndef NODE_AST
+#define NODE_AST
+
+#include <memory>
+#include <vector>
+
+#include "Node.hpp"
+
+/* Owns the nodes of a module in an arena, the root is the first node and the children of every node
+    are stored next to each other. Copies of an AST share the arena, clone() makes an independent copy
+    that can be modified without changing the original */
+class AST
+{
+    std::shared_ptr<std::vector<Node>> arena;
+
+    void copyForeignChildren(uint32_t index);
+
+public:
+    AST();
+    AST(const Node& root);
+
+    const Node& getRoot() const;
+    Node& getNode(uint32_t index);
+    uint32_t getChildIndex(uint32_t index, size_t N) const;
+
+    /* Appends the children after the last node and points the node to them, the previous children
+        are left in the arena unused. Subtrees of nodes from another AST are copied into this one */
+    void setChildren(uint32_t index, const std::vector<Node>& children);
+
+    void reserve(size_t nodeCount);
+
+    /* The copy has room for a few more nodes, so that small changes to it do not grow the arena */
+    AST clone() const;
+
+    size_t getNodeCount() const;
+    size_t getArenaBytes() const;
+};
+
+#endif
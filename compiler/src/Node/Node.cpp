@@ -2,6 +2,13 @@
 
 using namespace node;
 
+NodeList::NodeList()
+{
+    arena = nullptr;
+    first = 0;
+    count = 0;
+}
+
 Node::Node(NodeType nodeType, Token token)
 {
     type = nodeType;
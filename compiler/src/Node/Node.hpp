@@ -2,6 +2,7 @@
 #define NODE_NODE
 
 #include "../Token/Token.hpp"
+#include <cstdint>
 #include <vector>
 
 namespace node
@@ -73,11 +74,33 @@ namespace node
     };
 }
 
+struct Node;
+
+/* Children of a node, a range of consecutive nodes in the arena of the AST the node belongs to */
+class NodeList
+{
+    const std::vector<Node>* arena;
+    uint32_t first;
+    uint32_t count;
+
+    friend class AST;
+
+public:
+    NodeList();
+
+    size_t size() const;
+    bool empty() const;
+    const Node& operator[](size_t index) const;
+    const Node& back() const;
+    const Node* begin() const;
+    const Node* end() const;
+};
+
 struct Node
 {
     node::NodeType type;
     Token tok;
-    std::vector<Node> children;
+    NodeList children;
 
     Node(node::NodeType nodeType, Token token);
     Node();
@@ -92,4 +115,34 @@ struct Node
     bool isGenericTypeParamPresent() const;
 };
 
+inline size_t NodeList::size() const
+{
+    return count;
+}
+
+inline bool NodeList::empty() const
+{
+    return count == 0;
+}
+
+inline const Node& NodeList::operator[](size_t index) const
+{
+    return (*arena)[first + index];
+}
+
+inline const Node& NodeList::back() const
+{
+    return (*arena)[first + count - 1];
+}
+
+inline const Node* NodeList::begin() const
+{
+    return count == 0 ? nullptr : arena->data() + first;
+}
+
+inline const Node* NodeList::end() const
+{
+    return begin() + count;
+}
+
 #endif
\ No newline at end of file
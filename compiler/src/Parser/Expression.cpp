@@ -305,7 +305,7 @@ void term(parser::ParserContext& ctx)
             functionCall(ctx);
             methodCall(ctx);
         }
-        else if (ctx.matchedBracketPeek(token::OPEN_SQUARE, token::CLOSE_SQUARE, token::LPAREN))
+        else if (ctx.matchedBracketPeek(token::OPEN_SQUARE, token::LPAREN))
         {
             genericFunctionCall(ctx);
             methodCall(ctx);
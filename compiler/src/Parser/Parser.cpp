@@ -3,7 +3,7 @@
 
 #include "Parser.hpp"
 
-Node parser::generateAST(lexer::Lexer& lexer, Console& console)
+AST parser::generateAST(lexer::Lexer& lexer, Console& console)
 {
     parser::ParserContext parserContext(lexer, console);
     programModule(parserContext);
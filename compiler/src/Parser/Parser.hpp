@@ -3,11 +3,11 @@
 
 #include "../Console/Console.hpp"
 #include "../Lexer/Lexer.hpp"
-#include "../Node/Node.hpp"
+#include "../Node/AST.hpp"
 
 namespace parser
 {
-    Node generateAST(lexer::Lexer& lexer, Console& console);
+    AST generateAST(lexer::Lexer& lexer, Console& console);
 }
 
 #endif
\ No newline at end of file
@@ -9,15 +9,33 @@
 
 namespace parser
 {
+    constexpr uint32_t NO_NODE = UINT32_MAX;
+
     ParserContext::ParserContext(lexer::Lexer& lexer, Console& console)
         : lex(lexer)
         , console(console)
     {
-        currentNode = &ast;
+        currentNode = createNode(node::PROGRAM, Token());
 
         consume();
     }
 
+    uint32_t ParserContext::createNode(node::NodeType nodeType, const Token& token)
+    {
+        nodes.push_back(ParseNode{ nodeType, token, NO_NODE, NO_NODE, NO_NODE });
+        return nodes.size() - 1;
+    }
+
+    void ParserContext::appendChild(uint32_t parent, uint32_t child)
+    {
+        if (nodes[parent].firstChild == NO_NODE)
+            nodes[parent].firstChild = child;
+        else
+            nodes[nodes[parent].lastChild].nextSibling = child;
+
+        nodes[parent].lastChild = child;
+    }
+
     void ParserContext::consume()
     {
         /* Get next token from lexer's token queue */
@@ -36,9 +54,10 @@ namespace parser
         return type == lex.doublePeekToken().getType();
     }
 
-    bool ParserContext::matchedBracketPeek(token::TokenType open, token::TokenType close, token::TokenType type)
+    bool ParserContext::matchedBracketPeek(token::TokenType open, token::TokenType type)
     {
-        return type == lex.matchedBracketPeek(open, close).getType();
+        /* Peek the token after the bracket groups at the start of the token queue */
+        return type == lex.matchedBracketPeek(open).getType();
     }
 
     bool ParserContext::accept(token::TokenType type)
@@ -79,25 +98,25 @@ namespace parser
         /* Add child node to current node, if traverse iw true
             make current node the child node */
         /* Also fetch next symbol, if nexttoken is true */
-        currentNode->children.push_back(Node(nodeType, symbol));
+        appendChild(currentNode, createNode(nodeType, symbol));
 
         consume();
     }
 
     void ParserContext::addNodeMakeCurrent(node::NodeType nodeType)
     {
-        currentNode->children.push_back(Node(nodeType, symbol));
-
-        currentNode = &currentNode->children.back();
+        addNodeMakeCurrentNoConsume(nodeType);
 
         consume();
     }
 
     void ParserContext::addNodeMakeCurrentNoConsume(node::NodeType nodeType)
     {
-        currentNode->children.push_back(Node(nodeType, symbol));
+        const uint32_t child = createNode(nodeType, symbol);
 
-        currentNode = &currentNode->children.back();
+        appendChild(currentNode, child);
+
+        currentNode = child;
     }
 
     void ParserContext::insertNode(node::NodeType type)
@@ -105,15 +124,18 @@ namespace parser
         /* Adopts last child of current node
             and becomes the last child of current node */
 
-        Node new_node(type, currentNode->children.back().tok);
-
-        new_node.children.push_back(currentNode->children.back());
+        /* The last child moves to a new node and the new node takes its place */
+        const uint32_t lastChild = nodes[currentNode].lastChild;
 
-        currentNode->children.pop_back();
+        ParseNode adoptedChild = nodes[lastChild];
+        adoptedChild.nextSibling = NO_NODE;
+        nodes.push_back(adoptedChild);
 
-        currentNode->children.push_back(new_node);
+        nodes[lastChild].type = type;
+        nodes[lastChild].firstChild = nodes.size() - 1;
+        nodes[lastChild].lastChild = nodes.size() - 1;
 
-        currentNode = &currentNode->children.back();
+        currentNode = lastChild;
     }
 
     void ParserContext::insertNodeBeginning(node::NodeType type)
@@ -121,11 +143,13 @@ namespace parser
         /* Adopts ALL children of current node
             and becomes the last child of current node */
 
-        Node new_node(type, currentNode->children.back().tok);
+        const uint32_t newNode = createNode(type, nodes[nodes[currentNode].lastChild].tok);
 
-        std::swap(currentNode->children, new_node.children);
+        nodes[newNode].firstChild = nodes[currentNode].firstChild;
+        nodes[newNode].lastChild = nodes[currentNode].lastChild;
 
-        currentNode->children.push_back(new_node);
+        nodes[currentNode].firstChild = newNode;
+        nodes[currentNode].lastChild = newNode;
     }
 
     void ParserContext::duplicateNode()
@@ -134,13 +158,13 @@ namespace parser
             it to a new duplicate of the current node. The duplicate
             node becomes the child of the current node */
 
-        Node new_node(currentNode->type, symbol);
+        const uint32_t newNode = createNode(nodes[currentNode].type, symbol);
 
-        new_node.children = currentNode->children;
+        nodes[newNode].firstChild = nodes[currentNode].firstChild;
+        nodes[newNode].lastChild = nodes[currentNode].lastChild;
 
-        currentNode->children.clear();
-
-        currentNode->children.push_back(new_node);
+        nodes[currentNode].firstChild = newNode;
+        nodes[currentNode].lastChild = newNode;
 
         consume();
     }
@@ -158,8 +182,38 @@ namespace parser
         nodeStack.pop_back();
     }
 
-    Node ParserContext::getAST()
+    AST ParserContext::getAST()
     {
+        /* Nodes are laid out breadth first so the children of each node are next to each other,
+            queue holds pairs of parse node index and AST node index */
+
+        AST ast(Node(nodes[0].type, nodes[0].tok));
+        ast.reserve(nodes.size());
+
+        std::vector<std::pair<uint32_t, uint32_t>> queue = { { 0, 0 } };
+        std::vector<Node> children;
+
+        for (size_t i = 0; i < queue.size(); i += 1)
+        {
+            const uint32_t parseIndex = queue[i].first;
+            const uint32_t astIndex = queue[i].second;
+
+            children.clear();
+
+            for (uint32_t child = nodes[parseIndex].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+                children.push_back(Node(nodes[child].type, nodes[child].tok));
+
+            if (children.empty())
+                continue;
+
+            ast.setChildren(astIndex, children);
+
+            uint32_t childASTIndex = ast.getChildIndex(astIndex, 0);
+
+            for (uint32_t child = nodes[parseIndex].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+                queue.push_back({ child, childASTIndex++ });
+        }
+
         return ast;
     }
 
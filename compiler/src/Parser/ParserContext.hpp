@@ -1,12 +1,12 @@
 #ifndef PARSER
 #define PARSER
 
-#include <fstream>
+#include <cstdint>
 #include <vector>
 
 #include "../Console/Console.hpp"
 #include "../Lexer/Lexer.hpp"
-#include "../Node/Node.hpp"
+#include "../Node/AST.hpp"
 #include "../Token/Token.hpp"
 
 namespace parser
@@ -14,21 +14,34 @@ namespace parser
     class ParserContext
     {
 
+        /* Nodes link to their children while parsing so that a node can be inserted above existing
+            ones, getAST() lays them out in an arena once the module is parsed */
+        struct ParseNode
+        {
+            node::NodeType type;
+            Token tok;
+            uint32_t firstChild;
+            uint32_t lastChild;
+            uint32_t nextSibling;
+        };
+
         lexer::Lexer& lex;
         Console& console;
 
-        Node* currentNode;
-        std::vector<Node*> nodeStack;
+        std::vector<ParseNode> nodes;
+        uint32_t currentNode;
+        std::vector<uint32_t> nodeStack;
 
         Token symbol;
 
-        Node ast;
+        uint32_t createNode(node::NodeType nodeType, const Token& token);
+        void appendChild(uint32_t parent, uint32_t child);
 
     public:
         void consume();
         bool peek(token::TokenType type);
         bool dpeek(token::TokenType type);
-        bool matchedBracketPeek(token::TokenType open, token::TokenType close, token::TokenType type);
+        bool matchedBracketPeek(token::TokenType open, token::TokenType type);
         bool accept(token::TokenType type);
         int getOperatorPrecedence();
         void expect(token::TokenType type);
@@ -44,7 +57,7 @@ namespace parser
         void popNode();
 
         ParserContext(lexer::Lexer& lexer, Console& console);
-        Node getAST();
+        AST getAST();
     };
 }
 
@@ -205,7 +205,7 @@ void statement(parser::ParserContext& ctx)
             term(ctx);
         else if (ctx.peek(token::DOUBLE_COLON))
             term(ctx);
-        else if (ctx.matchedBracketPeek(token::OPEN_SQUARE, token::CLOSE_SQUARE, token::LPAREN))
+        else if (ctx.matchedBracketPeek(token::OPEN_SQUARE, token::LPAREN))
             term(ctx);
         else
             assignmentOrMethodCall(ctx);
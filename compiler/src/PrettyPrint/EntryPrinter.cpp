@@ -18,9 +18,9 @@ std::string operandToName(const icode::Operand& op)
             return icode::dataTypeToString(op.dtype) + "** tempPtrPtr" + std::to_string(op.operandId);
         case icode::VAR:
         case icode::GBL_VAR:
-            return icode::dataTypeToString(op.dtype) + " " + op.name;
+            return icode::dataTypeToString(op.dtype) + " " + icode::symbolName(op.name);
         case icode::PTR:
-            return icode::dataTypeToString(op.dtype) + "* " + op.name;
+            return icode::dataTypeToString(op.dtype) + "* " + icode::symbolName(op.name);
         case icode::RET_VALUE:
             return icode::dataTypeToString(op.dtype) + " returnValue" + std::to_string(op.operandId);
         case icode::RET_PTR:
@@ -30,7 +30,7 @@ std::string operandToName(const icode::Operand& op)
         case icode::CALLEE_RET_PTR:
             return icode::dataTypeToString(op.dtype) + "* calleeReturnPointer" + std::to_string(op.operandId);
         case icode::STR_DATA:
-            return "stringData " + op.name;
+            return "stringData " + icode::symbolName(op.name);
         case icode::BYTES:
             return "bytes " + std::to_string(op.val.bytes);
         case icode::LITERAL:
@@ -43,9 +43,9 @@ std::string operandToName(const icode::Operand& op)
             break;
         }
         case icode::LABEL:
-            return op.name;
+            return icode::symbolName(op.name);
         case icode::MODULE:
-            return "module " + op.name;
+            return "module " + icode::symbolName(op.name);
         case icode::NONE:
             return "";
         default:
@@ -1,4 +1,3 @@
-#include <fstream>
 #include <iostream>
 
 #include "FormatType.hpp"
@@ -44,38 +43,36 @@ namespace pp
 
     void errorOnToken(const std::string& moduleName,
                       const std::string& errorMessage,
-                      std::ifstream& file,
+                      const source::SourceFile& source,
                       const Token& tok)
     {
-        /* Prints the exact line from file using tok
+        /* Prints the exact line from source using tok
             and error message */
 
-        /* Goto beginning */
-        file.clear();
-        file.seekg(0, std::ios::beg);
-
-        /* Get line */
-        std::string line;
-        for (int i = 0; i < tok.getLineNo(); i++)
-            getline(file, line);
-
-        errorOnLine(moduleName, errorMessage, line, tok.getLineNo(), tok.getColumn());
+        errorOnLine(moduleName,
+                    errorMessage,
+                    std::string(source.getLine(tok.getLineNo())),
+                    tok.getLineNo(),
+                    tok.getColumn());
     }
 
-    void parserError(const std::string& moduleName, token::TokenType expected, Token& found, std::ifstream& file)
+    void parserError(const std::string& moduleName,
+                     token::TokenType expected,
+                     Token& found,
+                     const source::SourceFile& source)
     {
         /* Used by parser when it finds some other token type than expected */
 
         std::string errorMessage = "Did not expect " + tokenTypeToString[found.getType()];
         errorMessage += ",\nexpected " + tokenTypeToString[expected];
-        errorOnToken(moduleName, errorMessage, file, found);
+        errorOnToken(moduleName, errorMessage, source, found);
     }
 
     void parserErrorMultiple(const std::string& moduleName,
                              const token::TokenType* expected,
                              int ntoks,
                              const Token& found,
-                             std::ifstream& file)
+                             const source::SourceFile& source)
     {
         /* Used by parser when if finds a token type that does not match
            multiple token types expected */
@@ -88,11 +85,11 @@ namespace pp
 
         errorMessage += tokenTypeToString[expected[ntoks - 1]];
 
-        errorOnToken(moduleName, errorMessage, file, found);
+        errorOnToken(moduleName, errorMessage, source, found);
     }
 
     void typeError(const std::string& moduleName,
-                   std::ifstream& file,
+                   const source::SourceFile& source,
                    const Token& tok,
                    const icode::TypeDescription& expected,
                    const icode::TypeDescription& found)
@@ -112,11 +109,11 @@ namespace pp
 
         std::string errorMessage = "Type error, did not expect " + foundString + ", expected " + expectedString;
 
-        errorOnToken(moduleName, errorMessage, file, tok);
+        errorOnToken(moduleName, errorMessage, source, tok);
     }
 
     void operatorError(const std::string& moduleName,
-                       std::ifstream& file,
+                       const source::SourceFile& source,
                        const Token& tok,
                        const icode::TypeDescription& expected,
                        const icode::TypeDescription& found)
@@ -128,12 +125,12 @@ namespace pp
         std::string errorMessage = "Type error, operator '" + tok.toString() + "' does not exist for " + foundString +
                                    " and " + expectedString;
 
-        errorOnToken(moduleName, errorMessage, file, tok);
+        errorOnToken(moduleName, errorMessage, source, tok);
     }
 
-    void internalCompilerErrorToken(const std::string& moduleName, std::ifstream& file, const Token& tok)
+    void internalCompilerErrorToken(const std::string& moduleName, const source::SourceFile& source, const Token& tok)
     {
-        errorOnToken(moduleName, "Internal compiler error, REPORT THIS BUG", file, tok);
+        errorOnToken(moduleName, "Internal compiler error, REPORT THIS BUG", source, tok);
     }
 
     void internalCompileError(const std::string& moduleName)
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "../IntermediateRepresentation/TypeDescription.hpp"
+#include "../Source/SourceManager.hpp"
 #include "../Token/Token.hpp"
 
 namespace pp
@@ -22,30 +23,33 @@ namespace pp
 
     void errorOnToken(const std::string& moduleName,
                       const std::string& errorMessage,
-                      std::ifstream& file,
+                      const source::SourceFile& source,
                       const Token& token);
 
-    void parserError(const std::string& moduleName, token::TokenType expected, Token& found, std::ifstream& file);
+    void parserError(const std::string& moduleName,
+                     token::TokenType expected,
+                     Token& found,
+                     const source::SourceFile& source);
 
     void parserErrorMultiple(const std::string& moduleName,
                              const token::TokenType* expected,
                              int ntoks,
                              const Token& found,
-                             std::ifstream& file);
+                             const source::SourceFile& source);
 
     void typeError(const std::string& moduleName,
-                   std::ifstream& file,
+                   const source::SourceFile& source,
                    const Token& tok,
                    const icode::TypeDescription& expected,
                    const icode::TypeDescription& found);
 
     void operatorError(const std::string& moduleName,
-                       std::ifstream& file,
+                       const source::SourceFile& source,
                        const Token& tok,
                        const icode::TypeDescription& expected,
                        const icode::TypeDescription& found);
 
-    void internalCompilerErrorToken(const std::string& moduleName, std::ifstream& file, const Token& tok);
+    void internalCompilerErrorToken(const std::string& moduleName, const source::SourceFile& source, const Token& tok);
 
     void internalCompileError(const std::string& moduleName);
 }
@@ -30,11 +30,11 @@ namespace pp
             case icode::VAR:
             case icode::GBL_VAR:
             case icode::PTR:
-                jsonp.printString("name", op.name);
+                jsonp.printString("name", icode::symbolName(op.name));
                 jsonp.printString("dtype", icode::dataTypeToString(op.dtype));
                 break;
             case icode::STR_DATA:
-                jsonp.printString("name", op.name);
+                jsonp.printString("name", icode::symbolName(op.name));
                 jsonp.printNumber("size", op.val.size);
                 break;
             case icode::BYTES:
@@ -53,7 +53,7 @@ namespace pp
             }
             case icode::LABEL:
             case icode::MODULE:
-                jsonp.printString("name", op.name);
+                jsonp.printString("name", icode::symbolName(op.name));
                 break;
             case icode::NONE:
                 break;
@@ -118,7 +118,7 @@ namespace pp
         jsonp.end();
     }
 
-    void printTypeDescriptionMap(const std::map<std::string, icode::TypeDescription>& typeMap, FlatJSONPrinter& jsonp)
+    void printTypeDescriptionMap(const icode::SymbolTable<icode::TypeDescription>& typeMap, FlatJSONPrinter& jsonp)
     {
         jsonp.begin();
 
@@ -142,7 +142,7 @@ namespace pp
         jsonp.end();
     }
 
-    void printEnumDescriptionMap(const std::map<std::string, icode::EnumDescription>& enumsMap, FlatJSONPrinter& jsonp)
+    void printEnumDescriptionMap(const icode::SymbolTable<icode::EnumDescription>& enumsMap, FlatJSONPrinter& jsonp)
     {
         jsonp.begin();
 
@@ -171,7 +171,7 @@ namespace pp
         jsonp.end();
     }
 
-    void printStructDescriptionMap(const std::map<std::string, icode::StructDescription>& structsMap,
+    void printStructDescriptionMap(const icode::SymbolTable<icode::StructDescription>& structsMap,
                                    FlatJSONPrinter& jsonp)
     {
         jsonp.begin();
@@ -216,7 +216,7 @@ namespace pp
         jsonp.end();
     }
 
-    void printFunctionDescriptionMap(const std::map<std::string, icode::FunctionDescription>& functionsMap,
+    void printFunctionDescriptionMap(const icode::SymbolTable<icode::FunctionDescription>& functionsMap,
                                      FlatJSONPrinter& jsonp,
                                      bool jsonIR)
     {
@@ -324,7 +324,7 @@ namespace pp
         jsonp.end();
     }
 
-    void printFunctionDescriptionMapIcodeOnly(const std::map<std::string, icode::FunctionDescription>& functionsMap,
+    void printFunctionDescriptionMapIcodeOnly(const icode::SymbolTable<icode::FunctionDescription>& functionsMap,
                                               FlatJSONPrinter& jsonp,
                                               bool jsonIR)
     {
@@ -1,6 +1,6 @@
 #include "JSONMapUtil.hpp"
 
-void printStringMap(const std::map<std::string, std::string>& keyValueMap, FlatJSONPrinter& jsonp)
+void printStringMap(const icode::SymbolTable<std::string>& keyValueMap, FlatJSONPrinter& jsonp)
 {
     jsonp.begin();
 
@@ -1,13 +1,13 @@
 #ifndef PP_JSON_MAP_UTIL
 #define PP_JSON_MAP_UTIL
 
-#include <map>
 #include <string>
 
+#include "../../IntermediateRepresentation/SymbolTable.hpp"
 #include "FlatJSONPrinter.hpp"
 
 template<class V>
-void printNumberMap(const std::map<std::string, V>& keyValueMap, FlatJSONPrinter& jsonp)
+void printNumberMap(const icode::SymbolTable<V>& keyValueMap, FlatJSONPrinter& jsonp)
 {
     jsonp.begin();
 
@@ -17,6 +17,6 @@ void printNumberMap(const std::map<std::string, V>& keyValueMap, FlatJSONPrinter
     jsonp.end();
 }
 
-void printStringMap(const std::map<std::string, std::string>& keyValueMap, FlatJSONPrinter& jsonp);
+void printStringMap(const icode::SymbolTable<std::string>& keyValueMap, FlatJSONPrinter& jsonp);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include <deque>
+#include <ios>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SourceManager.hpp"
+
+namespace source
+{
+    /* Loaded files are only accessed from the thread generating IR, interned names and strings may be
+        created from translator threads as well so they are guarded by their own mutex */
+
+    static std::map<std::string, std::shared_ptr<const SourceFile>> loadedFiles;
+
+    static std::mutex fileNamesMutex;
+    static std::deque<std::string> fileNames = { "" };
+    static std::unordered_map<std::string, unsigned int> fileNameIds = { { "", 0 } };
+
+    static std::mutex internedStringsMutex;
+    static std::unordered_set<std::string> internedStrings;
+    static size_t internedStringBytes = 0;
+
+    static size_t mappedBytes = 0;
+
+    size_t SourceFile::getLineCount() const
+    {
+        return lineOffsets.size();
+    }
+
+    std::string_view SourceFile::getLine(int lineNo) const
+    {
+        if (lineNo < 1 || (size_t)lineNo > lineOffsets.size())
+            return std::string_view();
+
+        const size_t start = lineOffsets[lineNo - 1];
+        size_t end = (size_t)lineNo < lineOffsets.size() ? lineOffsets[lineNo] - 1 : size;
+
+        if (end == size && endsWithNewLine())
+            end -= 1;
+
+        return std::string_view(data + start, end - start);
+    }
+
+    bool SourceFile::endsWithNewLine() const
+    {
+        return size != 0 && data[size - 1] == '\n';
+    }
+
+    SourceFile::~SourceFile()
+    {
+        if (size == 0)
+            return;
+
+        munmap((void*)data, size);
+        mappedBytes -= size;
+    }
+
+    long long getModifiedTimeNanoseconds(const struct stat& fileStat)
+    {
+        return (long long)fileStat.st_mtim.tv_sec * 1000000000 + fileStat.st_mtim.tv_nsec;
+    }
+
+    bool isSameVersion(const SourceFile& sourceFile, const struct stat& fileStat)
+    {
+        return sourceFile.device == fileStat.st_dev && sourceFile.inode == fileStat.st_ino &&
+               sourceFile.size == (size_t)fileStat.st_size &&
+               sourceFile.modifiedTimeNanoseconds == getModifiedTimeNanoseconds(fileStat);
+    }
+
+    void splitLines(SourceFile& sourceFile)
+    {
+        if (sourceFile.size == 0)
+            return;
+
+        sourceFile.lineOffsets.push_back(0);
+
+        for (size_t i = 0; i + 1 < sourceFile.size; i += 1)
+            if (sourceFile.data[i] == '\n')
+                sourceFile.lineOffsets.push_back(i + 1);
+    }
+
+    std::shared_ptr<const SourceFile> mapFile(const std::string& path, int fd, const struct stat& fileStat)
+    {
+        std::shared_ptr<SourceFile> sourceFile = std::make_shared<SourceFile>();
+
+        sourceFile->fileId = internFileName(path);
+        sourceFile->device = fileStat.st_dev;
+        sourceFile->inode = fileStat.st_ino;
+        sourceFile->modifiedTimeNanoseconds = getModifiedTimeNanoseconds(fileStat);
+
+        if (fileStat.st_size != 0)
+        {
+            void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (mapping == MAP_FAILED)
+                throw std::ios_base::failure("Could not map " + path);
+
+            sourceFile->data = (const char*)mapping;
+            sourceFile->size = fileStat.st_size;
+            mappedBytes += sourceFile->size;
+        }
+
+        splitLines(*sourceFile);
+
+        return sourceFile;
+    }
+
+    std::shared_ptr<const SourceFile> loadFile(const std::string& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+
+        if (fd == -1)
+            throw std::ios_base::failure("Could not open " + path);
+
+        struct stat fileStat;
+
+        if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+        {
+            close(fd);
+            throw std::ios_base::failure("Could not read " + path);
+        }
+
+        auto loadedFile = loadedFiles.find(path);
+
+        if (loadedFile != loadedFiles.end() && isSameVersion(*loadedFile->second, fileStat))
+        {
+            close(fd);
+            return loadedFile->second;
+        }
+
+        std::shared_ptr<const SourceFile> sourceFile = mapFile(path, fd, fileStat);
+        close(fd);
+
+        /* The earlier version is unmapped once nothing holding its tokens is left */
+        loadedFiles[path] = sourceFile;
+
+        return sourceFile;
+    }
+
+    unsigned int internFileName(const std::string& fileName)
+    {
+        if (fileName.size() == 0)
+            return 0;
+
+        std::lock_guard<std::mutex> lock(fileNamesMutex);
+
+        auto fileNameId = fileNameIds.find(fileName);
+
+        if (fileNameId != fileNameIds.end())
+            return fileNameId->second;
+
+        fileNames.push_back(fileName);
+        fileNameIds[fileName] = fileNames.size() - 1;
+
+        return fileNames.size() - 1;
+    }
+
+    std::string getFileName(unsigned int fileId)
+    {
+        if (fileId == 0)
+            return "";
+
+        std::lock_guard<std::mutex> lock(fileNamesMutex);
+        return fileNames[fileId];
+    }
+
+    std::string_view internString(std::string_view str)
+    {
+        if (str.size() == 0)
+            return std::string_view();
+
+        std::lock_guard<std::mutex> lock(internedStringsMutex);
+
+        /* Elements of an unordered_set are never moved, so the views stay valid on rehash */
+        auto insertResult = internedStrings.emplace(str);
+
+        if (insertResult.second)
+            internedStringBytes += str.size();
+
+        return *insertResult.first;
+    }
+
+    size_t getMappedBytes()
+    {
+        return mappedBytes;
+    }
+
+    size_t getInternedStringBytes()
+    {
+        std::lock_guard<std::mutex> lock(internedStringsMutex);
+        return internedStringBytes;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef SOURCE_SOURCE_MANAGER
+#define SOURCE_SOURCE_MANAGER
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace source
+{
+    /* A memory mapped source file, tokens point into it so it is unmapped only when the last
+        shared pointer to it is released. Lines are split the same way std::getline splits them */
+    struct SourceFile
+    {
+        unsigned int fileId = 0;
+        const char* data = "";
+        size_t size = 0;
+
+        /* Identify the version of the file that was mapped, an editor saving through a temporary
+            file and a rename gives a new inode even when the size and the time stay the same */
+        unsigned long device = 0;
+        unsigned long inode = 0;
+        long long modifiedTimeNanoseconds = 0;
+
+        /* Offset of the first character of each line, the line after a trailing new line is not counted */
+        std::vector<size_t> lineOffsets;
+
+        size_t getLineCount() const;
+
+        /* Line numbers start from 1, returns empty line for line numbers out of range */
+        std::string_view getLine(int lineNo) const;
+
+        bool endsWithNewLine() const;
+
+        SourceFile() = default;
+        SourceFile(const SourceFile&) = delete;
+        SourceFile& operator=(const SourceFile&) = delete;
+        ~SourceFile();
+    };
+
+    /* Maps the file at path, a file that has not changed since it was last loaded is not mapped again.
+        A changed file is mapped again, the earlier mapping stays valid for whoever still holds a pointer
+        to it, generic ASTs kept by -serve for example. Throws std::ios_base::failure if the file cannot
+        be read */
+    std::shared_ptr<const SourceFile> loadFile(const std::string& path);
+
+    /* File names are interned to small ids so tokens do not have to keep a copy of the file name,
+        id 0 is always the empty file name */
+    unsigned int internFileName(const std::string& fileName);
+
+    std::string getFileName(unsigned int fileId);
+
+    /* Returns a copy of str that lives as long as the compiler, for token strings not in a source file */
+    std::string_view internString(std::string_view str);
+
+    size_t getMappedBytes();
+
+    size_t getInternedStringBytes();
+}
+
+#endif
@@ -1,3 +1,5 @@
+#include "../Source/SourceManager.hpp"
+
 #include "Token.hpp"
 
 using namespace token;
@@ -21,31 +23,30 @@ char toEscapedCharacter(char c)
     }
 }
 
-void Token::initializeUnescapedString()
+Token::Token(const std::string& fileName,
+             const std::string& tokenString,
+             TokenType tokenType,
+             unsigned int columnNumber,
+             unsigned int lineNumber)
 {
-    for (size_t i = 1; i < string.length() - 1; i++)
-    {
-        if (string[i] == '\\')
-            unescapedString += toEscapedCharacter(string[++i]);
-        else
-            unescapedString += string[i];
-    }
+    fileId = source::internFileName(fileName);
+    string = source::internString(tokenString);
+    type = tokenType;
+    column = columnNumber;
+    line = lineNumber;
 }
 
-Token::Token(std::string fileName,
-             std::string tokenString,
+Token::Token(unsigned int fileId,
+             std::string_view tokenString,
              TokenType tokenType,
              unsigned int columnNumber,
              unsigned int lineNumber)
 {
-    file = fileName;
+    this->fileId = fileId;
     string = tokenString;
     type = tokenType;
     column = columnNumber;
     line = lineNumber;
-
-    if (type == STR_LITERAL || type == CHAR_LITERAL || type == GENERATED)
-        initializeUnescapedString();
 }
 
 int Token::getPrecedence() const
@@ -128,24 +129,39 @@ bool Token::isEqualOrLeftArrow() const
 
 long Token::toInt() const
 {
-    if (string[0] == '0' && string[1] == 'b')
-        return std::stoul(string.substr(2), nullptr, 2);
+    if (string.size() > 1 && string[0] == '0' && string[1] == 'b')
+        return std::stoul(std::string(string.substr(2)), nullptr, 2);
 
-    return std::stoul(string, nullptr, 0);
+    return std::stoul(std::string(string), nullptr, 0);
 }
 
 double Token::toFloat() const
 {
-    return std::stod(string);
+    return std::stod(std::string(string));
 }
 
 std::string Token::toString() const
 {
-    return string;
+    return std::string(string);
 }
 
 std::string Token::toUnescapedString() const
 {
+    /* Strips the quotes and replaces escape sequences, only string and char literals have an unescaped string */
+
+    std::string unescapedString;
+
+    if (type != STR_LITERAL && type != CHAR_LITERAL && type != GENERATED)
+        return unescapedString;
+
+    for (size_t i = 1; i + 1 < string.length(); i++)
+    {
+        if (string[i] == '\\')
+            unescapedString += toEscapedCharacter(string[++i]);
+        else
+            unescapedString += string[i];
+    }
+
     return unescapedString;
 }
 
@@ -171,5 +187,5 @@ int Token::getColumn() const
 
 std::string Token::getFileName() const
 {
-    return file;
+    return source::getFileName(fileId);
 }
\ No newline at end of file
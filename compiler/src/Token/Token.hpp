@@ -2,6 +2,7 @@
 #define TOKEN_TOKEN
 
 #include <string>
+#include <string_view>
 
 namespace token
 {
@@ -104,15 +105,12 @@ namespace token
 
 class Token
 {
-    std::string string;
-    std::string unescapedString;
+    /* Points into a memory mapped source file or an interned string, see SourceManager */
+    std::string_view string;
     token::TokenType type;
     unsigned int column;
     unsigned int line;
-
-    std::string file;
-
-    void initializeUnescapedString();
+    unsigned int fileId;
 
 public:
     int getPrecedence() const;
@@ -133,11 +131,18 @@ public:
 
     std::string getFileName() const;
 
-    Token(std::string fileName = "",
-          std::string tokenString = "",
+    Token(const std::string& fileName = "",
+          const std::string& tokenString = "",
           token::TokenType tokenType = token::NONE,
           unsigned int column = 0,
           unsigned int linenumber = 0);
+
+    /* Used by the lexer, tokenString must live as long as the token */
+    Token(unsigned int fileId,
+          std::string_view tokenString,
+          token::TokenType tokenType,
+          unsigned int column,
+          unsigned int linenumber);
 };
 
 #endif
\ No newline at end of file
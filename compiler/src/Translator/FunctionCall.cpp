@@ -1,3 +1,5 @@
+#include "llvm/IR/IRBuilder.h"
+static llvm::Value* LL14Load(llvm::IRBuilder<>* b, llvm::Value* p, const llvm::Twine& n = "") { return b->CreateLoad(p->getType()->getPointerElementType(), p, n); }
 #include "GetAndSetLLVM.hpp"
 #include "StackAlloca.hpp"
 #include "ToLLVMType.hpp"
@@ -8,9 +10,7 @@ using namespace llvm;
 
 void pushParam(ModuleContext& ctx, const icode::Entry& e, Value* value)
 {
-    const std::string functionName = e.op2.name;
-
-    ctx.params[functionName].push_back(value);
+    ctx.params[e.op2.name].push_back(value);
 }
 
 Value* createCalleeReturnValue(const ModuleContext& ctx, const icode::TypeDescription& returnType)
@@ -23,10 +23,9 @@ Value* createCalleeReturnValue(const ModuleContext& ctx, const icode::TypeDescri
 
 void call(ModuleContext& ctx, const icode::Entry& e)
 {
-    const std::string functionName = e.op2.name;
-    const std::string moduleName = e.op3.name;
+    const std::string& functionName = icode::symbolName(e.op2.name);
 
-    const icode::FunctionDescription functionDescription = getFunctionDescription(ctx, functionName, moduleName);
+    const icode::FunctionDescription& functionDescription = getFunctionDescription(ctx, e.op2.name, e.op3.name);
     const icode::TypeDescription returnType = functionDescription.functionReturnType;
 
     Value* calleeReturnValuePointer = createCalleeReturnValue(ctx, returnType);
@@ -39,11 +38,11 @@ void call(ModuleContext& ctx, const icode::Entry& e)
     if (returnType.isStructOrArrayAndNotPointer())
     {
         pushParam(ctx, e, calleeReturnValuePointer);
-        ctx.builder->CreateCall(callee, ctx.params[functionName]);
+        ctx.builder->CreateCall(callee, ctx.params[e.op2.name]);
     }
     else
     {
-        Value* result = ctx.builder->CreateCall(callee, ctx.params[functionName]);
+        Value* result = ctx.builder->CreateCall(callee, ctx.params[e.op2.name]);
 
         if (returnType.dtype != icode::VOID)
             ctx.builder->CreateStore(result, calleeReturnValuePointer);
@@ -51,7 +50,7 @@ void call(ModuleContext& ctx, const icode::Entry& e)
 
     setLLVMValue(ctx, e.op1, calleeReturnValuePointer);
 
-    ctx.params[functionName].clear();
+    ctx.params[e.op2.name].clear();
 }
 
 void ret(const ModuleContext& ctx, const icode::TypeDescription& functionReturnType)
@@ -59,7 +58,7 @@ void ret(const ModuleContext& ctx, const icode::TypeDescription& functionReturnT
     if (functionReturnType.isStructOrArrayAndNotPointer() || functionReturnType.dtype == icode::VOID)
         ctx.builder->CreateRetVoid();
     else
-        ctx.builder->CreateRet(ctx.builder->CreateLoad(ctx.currentFunctionReturnValue));
+        ctx.builder->CreateRet(LL14Load(ctx.builder.get(), ctx.currentFunctionReturnValue));
 }
 
 void pass(ModuleContext& ctx, const icode::Entry& e)
@@ -1,3 +1,5 @@
+#include "llvm/IR/IRBuilder.h"
+static llvm::Value* LL14Load(llvm::IRBuilder<>* b, llvm::Value* p, const llvm::Twine& n = "") { return b->CreateLoad(p->getType()->getPointerElementType(), p, n); }
 #include "../IntermediateRepresentation/All.hpp"
 #include "CreateSymbol.hpp"
 #include "ToLLVMType.hpp"
@@ -20,23 +22,23 @@ Value* getLLVMConstant(const ModuleContext& ctx, const icode::Operand& op)
     ctx.console.internalBugError();
 }
 
-icode::FunctionDescription getFunctionDescription(const ModuleContext& ctx,
-                                                  const std::string& functionName,
-                                                  const std::string& moduleName)
+const icode::FunctionDescription& getFunctionDescription(const ModuleContext& ctx,
+                                                         icode::SymbolId functionName,
+                                                         icode::SymbolId moduleName)
 {
-    icode::FunctionDescription functionDescription;
+    const icode::FunctionDescription* functionDescription;
 
     /* For forward declared functions */
     if (ctx.moduleDescription.getExternFunction(functionName, functionDescription))
-        return functionDescription;
+        return *functionDescription;
 
-    icode::ModuleDescription functionModule = ctx.modulesMap.at(moduleName);
+    const icode::ModuleDescription& functionModule = ctx.modulesMap.at(icode::symbolName(moduleName));
 
     if (functionModule.getFunction(functionName, functionDescription))
-        return functionDescription;
+        return *functionDescription;
 
     if (functionModule.getExternFunction(functionName, functionDescription))
-        return functionDescription;
+        return *functionDescription;
 
     ctx.console.internalBugError();
 }
@@ -54,12 +56,12 @@ Function* getLLVMFunction(const ModuleContext& ctx,
 
 Value* getStringDataPointer(ModuleContext& ctx, const icode::Operand& op)
 {
-    auto result = ctx.operandGlobalStringMap.find(op.name);
+    auto result = ctx.operandGlobalStringMap.find(icode::symbolName(op.name));
 
     if (result != ctx.operandGlobalStringMap.end())
         return result->second;
 
-    return createExternGlobalString(ctx, op.name);
+    return createExternGlobalString(ctx, icode::symbolName(op.name));
 }
 
 Value* getLLVMPointer(ModuleContext& ctx, const icode::Operand& op)
@@ -67,21 +69,21 @@ Value* getLLVMPointer(ModuleContext& ctx, const icode::Operand& op)
     switch (op.operandType)
     {
         case icode::GBL_VAR:
-            return ctx.symbolNameGlobalsMap.at(op.name);
+            return ctx.symbolNameGlobalsMap.at(icode::symbolName(op.name));
         case icode::VAR:
-            return ctx.symbolNamePointersMap.at(op.name);
+            return ctx.symbolNamePointersMap.at(icode::symbolName(op.name));
         case icode::PTR:
-            return ctx.builder->CreateLoad(ctx.symbolNamePointersMap.at(op.name));
+            return LL14Load(ctx.builder.get(), ctx.symbolNamePointersMap.at(icode::symbolName(op.name)));
         case icode::RET_VALUE:
             return ctx.currentFunctionReturnValue;
         case icode::TEMP_PTR:
             return ctx.builder->CreateIntToPtr(getLLVMValue(ctx, op), dataTypeToLLVMPointerType(ctx, op.dtype));
         case icode::TEMP_PTR_PTR:
-            return ctx.builder->CreateLoad(getLLVMPointerToPointer(ctx, op));
+            return LL14Load(ctx.builder.get(), getLLVMPointerToPointer(ctx, op));
         case icode::CALLEE_RET_VAL:
             return ctx.operandValueMap.at(op.operandId);
         case icode::CALLEE_RET_PTR:
-            return ctx.builder->CreateLoad(ctx.operandValueMap.at(op.operandId));
+            return LL14Load(ctx.builder.get(), ctx.operandValueMap.at(op.operandId));
         case icode::STR_DATA:
             return getStringDataPointer(ctx, op);
         default:
@@ -99,7 +101,7 @@ Value* getLLVMValue(ModuleContext& ctx, const icode::Operand& op)
         case icode::VAR:
         case icode::GBL_VAR:
         case icode::CALLEE_RET_VAL:
-            return ctx.builder->CreateLoad(getLLVMPointer(ctx, op), op.name.c_str());
+            return LL14Load(ctx.builder.get(), getLLVMPointer(ctx, op), icode::symbolName(op.name).c_str());
         case icode::PTR:
         case icode::CALLEE_RET_PTR:
         case icode::TEMP_PTR_PTR:
@@ -138,7 +140,7 @@ Value* getLLVMPointerToPointer(ModuleContext& ctx, const icode::Operand& op)
     switch (op.operandType)
     {
         case icode::PTR:
-            return ctx.symbolNamePointersMap.at(op.name);
+            return ctx.symbolNamePointersMap.at(icode::symbolName(op.name));
         case icode::RET_PTR:
             return ctx.currentFunctionReturnValue;
         case icode::TEMP_PTR_PTR:
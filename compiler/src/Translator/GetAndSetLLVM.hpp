@@ -12,9 +12,9 @@ llvm::Function* getLLVMFunction(const ModuleContext& ctx,
                                 const std::string& functionName,
                                 const icode::FunctionDescription& functionDescription);
 
-icode::FunctionDescription getFunctionDescription(const ModuleContext& ctx,
-                                                  const std::string& functionName,
-                                                  const std::string& moduleName);
+const icode::FunctionDescription& getFunctionDescription(const ModuleContext& ctx,
+                                                         icode::SymbolId functionName,
+                                                         icode::SymbolId moduleName);
 
 llvm::Value* getLLVMPointer(ModuleContext& ctx, const icode::Operand& op);
 
@@ -1,14 +1,29 @@
+#include <atomic>
+#include <future>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Analysis/LoopAnalysisManager.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/Passes/PassBuilder.h"
+#include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Transforms/IPO/Internalize.h"
+
+#include "../Builder/NameMangle.hpp"
+#include "../IntermediateRepresentation/ModuleReferences.hpp"
+#include "../Utils/MemoryReport.hpp"
+#include "../Utils/PhaseTimer.hpp"
 
 #include "BranchContext.hpp"
 #include "FormatStringsContext.hpp"
 #include "GenerateModule.hpp"
+#include "ObjectCache.hpp"
 #include "Print.hpp"
 #include "SetupLLVM.hpp"
 
@@ -16,14 +31,52 @@
 
 using namespace llvm;
 
-void optimizeModule(ModuleContext& ctx)
+OptimizationLevel getPassBuilderOptimizationLevel(translator::OptimizationLevel optimizationLevel)
+{
+    std::map<translator::OptimizationLevel, OptimizationLevel> optimizationLevelMap = {
+        { translator::O0, OptimizationLevel::O0 }, { translator::O1, OptimizationLevel::O1 },
+        { translator::O2, OptimizationLevel::O2 }, { translator::O3, OptimizationLevel::O3 },
+        { translator::Os, OptimizationLevel::Os }, { translator::Oz, OptimizationLevel::Oz },
+    };
+
+    return optimizationLevelMap.at(optimizationLevel);
+}
+
+std::string translator::getProfileError(const std::string& profileFileName)
+{
+    /* Checked once by the driver, LLVM would exit without a proper error message on a bad profile */
+    auto profileReader = IndexedInstrProfReader::create(profileFileName);
+
+    if (Error error = profileReader.takeError())
+        return toString(std::move(error));
+
+    return "";
+}
+
+Optional<PGOOptions> getPGOOptions(const translator::Target& target)
 {
+    if (target.profileGenerate)
+        return PGOOptions("", "", "", PGOOptions::IRInstr);
+
+    if (target.profileUseFileName == "")
+        return None;
+
+    return PGOOptions(target.profileUseFileName, "", "", PGOOptions::IRUse);
+}
+
+void optimizeModule(ModuleContext& ctx,
+                    const translator::Target& target,
+                    translator::OptimizationLevel optimizationLevel,
+                    TargetMachine& targetMachine)
+{
+    timer::ScopedPhase phase("Optimization", ctx.moduleDescription.name);
+
     LoopAnalysisManager LAM;
     FunctionAnalysisManager FAM;
     CGSCCAnalysisManager CGAM;
     ModuleAnalysisManager MAM;
 
-    PassBuilder PB;
+    PassBuilder PB(&targetMachine, PipelineTuningOptions(), getPGOOptions(target));
 
     FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
 
@@ -33,33 +86,214 @@ void optimizeModule(ModuleContext& ctx)
     PB.registerLoopAnalyses(LAM);
     PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
 
-    ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(PassBuilder::OptimizationLevel::O3);
+    ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(getPassBuilderOptimizationLevel(optimizationLevel));
 
     MPM.run(*ctx.LLVMModule, MAM);
 }
 
-void generateLLVMModule(ModuleContext& ctx, bool release, Console& console)
+void translateModule(ModuleContext& ctx)
 {
-    BranchContext branchContext;
-    FormatStringsContext formatStringsContext;
+    {
+        timer::ScopedPhase phase("LLVM translation", ctx.moduleDescription.name);
 
-    generateModule(ctx, branchContext, formatStringsContext);
+        BranchContext branchContext;
+        FormatStringsContext formatStringsContext;
 
-    initializeTargetRegistry();
+        generateModule(ctx, branchContext, formatStringsContext);
+    }
 
-    if (release)
-        optimizeModule(ctx);
+    memory::recordLLVMModule(ctx.moduleDescription.name, *ctx.LLVMModule);
+}
+
+void generateLLVMModule(ModuleContext& ctx,
+                        const translator::Target& target,
+                        translator::OptimizationLevel optimizationLevel,
+                        TargetMachine& targetMachine)
+{
+    translateModule(ctx);
+    setModuleTarget(ctx, targetMachine);
+
+    if (optimizationLevel != translator::O0)
+        optimizeModule(ctx, target, optimizationLevel, targetMachine);
 }
 
 void translator::generateObject(icode::ModuleDescription& moduleDescription,
                                 icode::StringModulesMap& modulesMap,
-                                Platform platform,
-                                bool release,
+                                const Target& target,
+                                OptimizationLevel optimizationLevel,
                                 Console& console)
 {
     ModuleContext moduleContext(moduleDescription, modulesMap, console);
-    generateLLVMModule(moduleContext, release, console);
-    setupPassManagerAndCreateObject(moduleContext, platform);
+    std::unique_ptr<TargetMachine> targetMachine = acquireTargetMachine(moduleContext, target, optimizationLevel);
+
+    generateLLVMModule(moduleContext, target, optimizationLevel, *targetMachine);
+    setupPassManagerAndCreateObject(moduleContext,
+                                    *targetMachine,
+                                    createDirsAndGetOutputObjNameStatic(moduleDescription.name));
+
+    releaseTargetMachine(target, optimizationLevel, std::move(targetMachine));
+}
+
+void generateObjectOrRestoreFromCache(icode::ModuleDescription& moduleDescription,
+                                      icode::StringModulesMap& modulesMap,
+                                      const translator::Target& target,
+                                      translator::OptimizationLevel optimizationLevel,
+                                      ObjectCache* objectCache,
+                                      Console& console)
+{
+    const std::string objectFileName = createDirsAndGetOutputObjNameStatic(moduleDescription.name);
+
+    if (objectCache && objectCache->restoreObject(moduleDescription.name, objectFileName))
+        return;
+
+    translator::generateObject(moduleDescription, modulesMap, target, optimizationLevel, console);
+
+    if (objectCache)
+        objectCache->storeObject(moduleDescription.name, objectFileName);
+}
+
+void translator::generateObjects(icode::StringModulesMap& modulesMap,
+                                 const Target& target,
+                                 OptimizationLevel optimizationLevel,
+                                 unsigned int jobs,
+                                 bool cache,
+                                 Console& console)
+{
+    /* Each module is translated in its own ModuleContext (and LLVMContext), so modules
+        can be translated and emitted concurrently, modulesMap is only read from here on */
+
+    std::unique_ptr<ObjectCache> objectCache;
+
+    if (cache)
+        objectCache = std::make_unique<ObjectCache>(modulesMap, target, optimizationLevel);
+
+    std::vector<icode::ModuleDescription*> modules;
+
+    for (auto& stringModulePair : modulesMap)
+        modules.push_back(&stringModulePair.second);
+
+    if (jobs <= 1 || modules.size() <= 1)
+    {
+        for (icode::ModuleDescription* moduleDescription : modules)
+        {
+            generateObjectOrRestoreFromCache(*moduleDescription,
+                                             modulesMap,
+                                             target,
+                                             optimizationLevel,
+                                             objectCache.get(),
+                                             console);
+        }
+    }
+    else
+    {
+        std::atomic<size_t> nextModuleIndex(0);
+        std::atomic<bool> failed(false);
+
+        auto worker = [&]()
+        {
+            try
+            {
+                for (size_t i = nextModuleIndex++; i < modules.size() && !failed; i = nextModuleIndex++)
+                {
+                    generateObjectOrRestoreFromCache(*modules[i],
+                                                     modulesMap,
+                                                     target,
+                                                     optimizationLevel,
+                                                     objectCache.get(),
+                                                     console);
+                }
+            }
+            catch (...)
+            {
+                failed = true;
+                throw;
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+
+        for (unsigned int i = 0; i < std::min<size_t>(jobs, modules.size()); i += 1)
+            workers.push_back(std::async(std::launch::async, worker));
+
+        /* Wait for all workers before rethrowing the first error, if any */
+        for (std::future<void>& workerFuture : workers)
+            workerFuture.wait();
+
+        for (std::future<void>& workerFuture : workers)
+            workerFuture.get();
+    }
+
+    if (objectCache)
+        pp::println(objectCache->getSummary());
+}
+
+bool isExportedFunction(const std::string& functionName, const icode::FunctionDescription& function)
+{
+    /* Functions that are not name mangled, main and extern C functions, can be called from outside */
+    const std::string manglePrefix = nameMangleString("", function.moduleName);
+    return functionName.compare(0, manglePrefix.size(), manglePrefix) != 0;
+}
+
+void translator::generateLTOObject(icode::ModuleDescription& rootModule,
+                                   icode::StringModulesMap& modulesMap,
+                                   const Target& target,
+                                   OptimizationLevel optimizationLevel,
+                                   Console& console)
+{
+    /* Every module is translated into the root module's LLVMContext and linked into the root
+        module, so calls across modules can be inlined. All functions except the exported ones
+        are internalized before optimizing so unused definitions are removed. The result is the
+        only object needed to link the executable, it is written to _obj/_lto */
+
+    ModuleContext rootContext(rootModule, modulesMap, console);
+    translateModule(rootContext);
+
+    std::set<std::string> exportedFunctions;
+
+    for (auto& stringModulePair : modulesMap)
+    {
+        for (const auto& function : stringModulePair.second.functions)
+            if (isExportedFunction(function.first, function.second))
+                exportedFunctions.insert(function.first);
+
+        if (&stringModulePair.second == &rootModule)
+            continue;
+
+        ModuleContext moduleContext(stringModulePair.second, modulesMap, *rootContext.context, console);
+        translateModule(moduleContext);
+
+        timer::ScopedPhase phase("Linking", stringModulePair.first);
+
+        if (Linker::linkModules(*rootContext.LLVMModule, std::move(moduleContext.LLVMModule)))
+            console.internalBugErrorMessage("LLVM ERROR: Could not link module " + stringModulePair.first);
+    }
+
+    internalizeModule(*rootContext.LLVMModule,
+                      [&](const GlobalValue& global) { return exportedFunctions.count(global.getName().str()) != 0; });
+
+    std::unique_ptr<TargetMachine> targetMachine = acquireTargetMachine(rootContext, target, optimizationLevel);
+    setModuleTarget(rootContext, *targetMachine);
+
+    if (optimizationLevel != O0)
+        optimizeModule(rootContext, target, optimizationLevel, *targetMachine);
+
+    setupPassManagerAndCreateObject(rootContext, *targetMachine, createDirsAndGetLTOObjName(rootModule.name));
+
+    releaseTargetMachine(target, optimizationLevel, std::move(targetMachine));
+}
+
+std::vector<std::string> translator::getObjectFileNames(const icode::StringModulesMap& modulesMap,
+                                                       const std::string& rootModuleName)
+{
+    /* Objects needed to link the executable of the root module, when the modules map holds
+        modules of other root modules as well */
+
+    std::vector<std::string> objectFileNames = { createDirsAndGetOutputObjNameStatic(rootModuleName) };
+
+    for (const std::string& moduleName : icode::getTransitiveLinkedModules(modulesMap, rootModuleName))
+        objectFileNames.push_back(createDirsAndGetOutputObjNameStatic(moduleName));
+
+    return objectFileNames;
 }
 
 std::string getLLVMModuleString(const Module& LLVMModule)
@@ -74,10 +308,16 @@ std::string getLLVMModuleString(const Module& LLVMModule)
 
 std::string translator::generateLLVMModuleString(icode::ModuleDescription& moduleDescription,
                                                  icode::StringModulesMap& modulesMap,
-                                                 bool release,
+                                                 const Target& target,
+                                                 OptimizationLevel optimizationLevel,
                                                  Console& console)
 {
     ModuleContext moduleContext(moduleDescription, modulesMap, console);
-    generateLLVMModule(moduleContext, release, console);
+    std::unique_ptr<TargetMachine> targetMachine = acquireTargetMachine(moduleContext, target, optimizationLevel);
+
+    generateLLVMModule(moduleContext, target, optimizationLevel, *targetMachine);
+
+    releaseTargetMachine(target, optimizationLevel, std::move(targetMachine));
+
     return getLLVMModuleString(*moduleContext.LLVMModule);
 }
@@ -4,20 +4,40 @@
 #include "../IntermediateRepresentation/All.hpp"
 
 #include "ModuleContext.hpp"
-#include "Platform.hpp"
+#include "OptimizationLevel.hpp"
+#include "Target.hpp"
 
 namespace translator
 {
     void generateObject(icode::ModuleDescription& moduleDescription,
                         icode::StringModulesMap& modulesMap,
-                        Platform platform,
-                        bool release,
+                        const Target& target,
+                        OptimizationLevel optimizationLevel,
                         Console& console);
 
+    void generateObjects(icode::StringModulesMap& modulesMap,
+                         const Target& target,
+                         OptimizationLevel optimizationLevel,
+                         unsigned int jobs,
+                         bool cache,
+                         Console& console);
+
+    void generateLTOObject(icode::ModuleDescription& rootModule,
+                           icode::StringModulesMap& modulesMap,
+                           const Target& target,
+                           OptimizationLevel optimizationLevel,
+                           Console& console);
+
+    std::vector<std::string> getObjectFileNames(const icode::StringModulesMap& modulesMap,
+                                                const std::string& rootModuleName);
+
     std::string generateLLVMModuleString(icode::ModuleDescription& moduleDescription,
                                          icode::StringModulesMap& modulesMap,
-                                         bool release,
+                                         const Target& target,
+                                         OptimizationLevel optimizationLevel,
                                          Console& console);
+
+    std::string getProfileError(const std::string& profileFileName);
 }
 
 #endif
\ No newline at end of file
@@ -7,11 +7,27 @@ using namespace llvm;
 ModuleContext::ModuleContext(icode::ModuleDescription& moduleDescription,
                              icode::StringModulesMap& modulesMap,
                              Console& console)
-    : moduleDescription(moduleDescription)
+    : ownedContext(std::make_unique<LLVMContext>())
+    , context(ownedContext.get())
+    , moduleDescription(moduleDescription)
     , modulesMap(modulesMap)
     , console(console)
 {
-    context = std::make_unique<LLVMContext>();
+    LLVMModule = std::make_unique<Module>(moduleDescription.name, *context);
+    builder = std::make_unique<IRBuilder<>>(*context);
+    currentWorkingFunction = nullptr;
+}
+
+ModuleContext::ModuleContext(icode::ModuleDescription& moduleDescription,
+                             icode::StringModulesMap& modulesMap,
+                             LLVMContext& sharedContext,
+                             Console& console)
+    : context(&sharedContext)
+    , moduleDescription(moduleDescription)
+    , modulesMap(modulesMap)
+    , console(console)
+{
+    /* Modules that are linked together must share one LLVMContext */
     LLVMModule = std::make_unique<Module>(moduleDescription.name, *context);
     builder = std::make_unique<IRBuilder<>>(*context);
     currentWorkingFunction = nullptr;
@@ -14,7 +14,8 @@
 
 struct ModuleContext
 {
-    std::unique_ptr<llvm::LLVMContext> context;
+    std::unique_ptr<llvm::LLVMContext> ownedContext;
+    llvm::LLVMContext* context;
     std::unique_ptr<llvm::Module> LLVMModule;
     std::unique_ptr<llvm::IRBuilder<>> builder;
 
@@ -26,7 +27,7 @@ struct ModuleContext
     icode::ModuleDescription& moduleDescription;
     icode::StringModulesMap& modulesMap;
 
-    std::map<std::string, std::vector<llvm::Value*>> params;
+    std::map<icode::SymbolId, std::vector<llvm::Value*>> params;
     llvm::Value* currentFunctionReturnValue;
     llvm::Function* currentWorkingFunction;
 
@@ -34,6 +35,11 @@ struct ModuleContext
 
     ModuleContext(icode::ModuleDescription& moduleDescription, icode::StringModulesMap& modulesMap, Console& console);
 
+    ModuleContext(icode::ModuleDescription& moduleDescription,
+                  icode::StringModulesMap& modulesMap,
+                  llvm::LLVMContext& sharedContext,
+                  Console& console);
+
     void clear();
 };
 
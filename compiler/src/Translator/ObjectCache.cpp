@@ -0,0 +1,320 @@
+#include <filesystem>
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA1.h"
+
+#include "../IntermediateRepresentation/ModuleReferences.hpp"
+#include "../Utils/CachePath.hpp"
+#include "../config.hpp"
+
+#include "SetupLLVM.hpp"
+
+#include "ObjectCache.hpp"
+
+namespace fs = std::filesystem;
+
+/* Objects are cached by a SHA1 of everything the translator reads to create them, the module's IR,
+    the interface (structs and function signatures) of all modules it refers to, the target and
+    the compiler version */
+
+class IRHasher
+{
+    llvm::SHA1 sha;
+
+public:
+    void add(const std::string& str)
+    {
+        add((unsigned long)str.size());
+        sha.update(str);
+    }
+
+    void add(unsigned long value)
+    {
+        sha.update(llvm::StringRef((const char*)&value, sizeof(value)));
+    }
+
+    void add(const std::vector<std::string>& strings)
+    {
+        add((unsigned long)strings.size());
+
+        for (const std::string& str : strings)
+            add(str);
+    }
+
+    void add(const icode::TypeDescription& type)
+    {
+        add((unsigned long)type.dtype);
+        add(type.dtypeName);
+        add(type.moduleName);
+        add((unsigned long)type.dtypeSize);
+        add((unsigned long)type.offset);
+        add((unsigned long)type.size);
+        add((unsigned long)type.properties);
+
+        add((unsigned long)type.dimensions.size());
+
+        for (size_t i = 0; i < type.dimensions.size(); i += 1)
+        {
+            add((unsigned long)type.dimensions[i]);
+            add((unsigned long)type.dimTypes[i]);
+        }
+    }
+
+    void add(const icode::Operand& op)
+    {
+        add((unsigned long)op.operandType);
+        add((unsigned long)op.operandId);
+        add((unsigned long)op.dtype);
+        add(icode::symbolName(op.name));
+
+        /* The value union is only initialized for these operands */
+        if (op.operandType == icode::LITERAL || op.operandType == icode::BYTES || op.operandType == icode::STR_DATA)
+            add(op.val.bytes);
+    }
+
+    void add(const icode::FunctionDescription& function)
+    {
+        add(function.functionReturnType);
+        add(function.parameters);
+        add(function.moduleName);
+        add(function.absoluteName);
+
+        add((unsigned long)function.symbols.size());
+
+        for (const auto& symbol : function.symbols)
+        {
+            add(symbol.first);
+            add(symbol.second);
+        }
+
+        add((unsigned long)function.icodeTable.size());
+
+        for (const icode::Entry& e : function.icodeTable)
+        {
+            add((unsigned long)e.opcode);
+            add(e.op1);
+            add(e.op2);
+            add(e.op3);
+        }
+    }
+
+    void add(const icode::StructDescription& structDescription)
+    {
+        add(structDescription.moduleName);
+        add((unsigned long)structDescription.size);
+        add(structDescription.fieldNames);
+        add(structDescription.deconstructor);
+
+        for (const auto& field : structDescription.structFields)
+        {
+            add(field.first);
+            add(field.second);
+        }
+    }
+
+    void add(const icode::EnumDescription& enumDescription)
+    {
+        add(enumDescription.dtypeName);
+        add((unsigned long)enumDescription.value);
+        add(enumDescription.moduleName);
+    }
+
+    void add(double value)
+    {
+        sha.update(llvm::StringRef((const char*)&value, sizeof(value)));
+    }
+
+    void add(long value)
+    {
+        add((unsigned long)value);
+    }
+
+    void add(int value)
+    {
+        add((unsigned long)value);
+    }
+
+    template <class V>
+    void add(const icode::SymbolTable<V>& map)
+    {
+        add((unsigned long)map.size());
+
+        for (const auto& pair : map)
+        {
+            add(pair.first);
+            add(pair.second);
+        }
+    }
+
+    void add(const icode::ModuleDescription& module)
+    {
+        add(module.name);
+        add(module.uses);
+        add(module.aliases);
+        add(module.incompleteTypes);
+        add(module.structures);
+        add(module.definedFunctions);
+        add(module.incompleteFunctions);
+        add(module.functions);
+        add(module.externFunctions);
+        add(module.definedEnumsTypes);
+        add(module.enums);
+        add(module.intDefines);
+        add(module.floatDefines);
+        add(module.globals);
+        add(module.stringDefines);
+        add(module.stringsData);
+        add(module.stringsDataCharCounts);
+    }
+
+    void addSignature(const icode::FunctionDescription& function)
+    {
+        add(function.functionReturnType);
+        add(function.parameters);
+        add(function.moduleName);
+        add(function.absoluteName);
+
+        for (const std::string& parameter : function.parameters)
+            add(function.symbols.at(parameter));
+    }
+
+    void addInterface(const icode::ModuleDescription& module)
+    {
+        add(module.name);
+        add(module.structures);
+
+        add((unsigned long)module.functions.size());
+
+        for (const auto& function : module.functions)
+        {
+            add(function.first);
+            addSignature(function.second);
+        }
+
+        add((unsigned long)module.externFunctions.size());
+
+        for (const auto& function : module.externFunctions)
+        {
+            add(function.first);
+            addSignature(function.second);
+        }
+    }
+
+    std::string getHash()
+    {
+        return llvm::toHex(sha.final(), true);
+    }
+};
+
+ObjectCache::ObjectCache(const icode::StringModulesMap& modulesMap,
+                         const translator::Target& target,
+                         translator::OptimizationLevel optimizationLevel)
+    : hits(0)
+    , misses(0)
+{
+    cacheDirectory = getCacheDirectory();
+
+    /* An unreadable profile is reported by the translator when the objects are generated */
+    std::string profileContents;
+
+    if (target.profileUseFileName != "")
+    {
+        auto profileBuffer = llvm::MemoryBuffer::getFile(target.profileUseFileName);
+
+        if (profileBuffer)
+            profileContents = (*profileBuffer)->getBuffer().str();
+    }
+
+    std::map<std::string, std::string> moduleInterfaceHashes;
+
+    for (const auto& stringModulePair : modulesMap)
+    {
+        IRHasher hasher;
+        hasher.addInterface(stringModulePair.second);
+        moduleInterfaceHashes[stringModulePair.first] = hasher.getHash();
+    }
+
+    for (const auto& stringModulePair : modulesMap)
+    {
+        IRHasher hasher;
+
+        hasher.add(std::string(VERSION));
+        hasher.add(std::string(LLVM_VERSION_STRING));
+        hasher.add(getTargetTriple(target.platform));
+        hasher.add(getTargetCPU(target));
+        hasher.add(getTargetFeatures(target));
+        hasher.add((unsigned long)target.profileGenerate);
+        hasher.add(profileContents);
+        hasher.add((unsigned long)optimizationLevel);
+        hasher.add(stringModulePair.second);
+
+        for (const std::string& moduleName : icode::getTransitiveReferencedModules(modulesMap, stringModulePair.first))
+            hasher.add(moduleInterfaceHashes.at(moduleName));
+
+        moduleKeys[stringModulePair.first] = hasher.getHash();
+    }
+}
+
+std::string getCachedObjectPath(const std::string& cacheDirectory, const std::string& key)
+{
+    /* Does not end with .o, so globbing _obj for objects does not pick up cached objects */
+    return (fs::path(cacheDirectory) / (key + ".objcache")).string();
+}
+
+bool ObjectCache::restoreObject(const std::string& moduleName, const std::string& objectFileName)
+{
+    const std::string cachedObjectPath = getCachedObjectPath(cacheDirectory, moduleKeys.at(moduleName));
+
+    std::error_code ec;
+
+    if (!fs::exists(cachedObjectPath, ec))
+    {
+        misses++;
+        return false;
+    }
+
+    fs::copy_file(cachedObjectPath, objectFileName, fs::copy_options::overwrite_existing, ec);
+
+    if (ec)
+    {
+        misses++;
+        return false;
+    }
+
+    hits++;
+    return true;
+}
+
+void ObjectCache::storeObject(const std::string& moduleName, const std::string& objectFileName)
+{
+    /* Failing to populate the cache should not fail the build, so errors are ignored here.
+        The object is copied to a unique temporary file first and then renamed, so concurrent
+        compiles sharing the same cache never see a partially written object */
+
+    const std::string cachedObjectPath = getCachedObjectPath(cacheDirectory, moduleKeys.at(moduleName));
+
+    std::error_code ec;
+    fs::create_directories(cacheDirectory, ec);
+
+    llvm::SmallString<128> temporaryPath;
+    llvm::sys::fs::createUniquePath(cachedObjectPath + "-%%%%%%%%.tmp", temporaryPath, false);
+
+    fs::copy_file(objectFileName, temporaryPath.str().str(), ec);
+
+    if (ec)
+        return;
+
+    fs::rename(temporaryPath.str().str(), cachedObjectPath, ec);
+
+    if (ec)
+        fs::remove(temporaryPath.str().str(), ec);
+}
+
+std::string ObjectCache::getSummary() const
+{
+    return "Object cache: " + std::to_string(hits) + " hit(s), " + std::to_string(misses) + " miss(es)";
+}
@@ -0,0 +1,32 @@
+#ifndef TRANSLATOR_OBJECT_CACHE
+#define TRANSLATOR_OBJECT_CACHE
+
+#include <atomic>
+#include <map>
+#include <string>
+
+#include "../IntermediateRepresentation/All.hpp"
+#include "OptimizationLevel.hpp"
+#include "Target.hpp"
+
+class ObjectCache
+{
+    std::string cacheDirectory;
+    std::map<std::string, std::string> moduleKeys;
+
+    std::atomic<unsigned int> hits;
+    std::atomic<unsigned int> misses;
+
+public:
+    ObjectCache(const icode::StringModulesMap& modulesMap,
+                const translator::Target& target,
+                translator::OptimizationLevel optimizationLevel);
+
+    bool restoreObject(const std::string& moduleName, const std::string& objectFileName);
+
+    void storeObject(const std::string& moduleName, const std::string& objectFileName);
+
+    std::string getSummary() const;
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef TRANSLATOR_OPTIMIZATION_LEVEL
+#define TRANSLATOR_OPTIMIZATION_LEVEL
+
+namespace translator
+{
+    enum OptimizationLevel
+    {
+        O0,
+        O1,
+        O2,
+        O3,
+        Os,
+        Oz,
+    };
+}
+
+#endif
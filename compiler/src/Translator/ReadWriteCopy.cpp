@@ -1,3 +1,5 @@
+#include "llvm/IR/IRBuilder.h"
+static llvm::Value* LL14Load(llvm::IRBuilder<>* b, llvm::Value* p, const llvm::Twine& n = "") { return b->CreateLoad(p->getType()->getPointerElementType(), p, n); }
 #include "GetAndSetLLVM.hpp"
 #include "ToLLVMType.hpp"
 
@@ -55,7 +57,7 @@ void read(ModuleContext& ctx, const icode::Entry& e)
     /* Converts ShnooTalk READ to llvm ir */
 
     Value* sourcePointer = getLLVMPointer(ctx, e.op2);
-    Value* sourceValue = ctx.builder->CreateLoad(sourcePointer);
+    Value* sourceValue = LL14Load(ctx.builder.get(), sourcePointer);
 
     setLLVMValue(ctx, e.op1, sourceValue);
 }
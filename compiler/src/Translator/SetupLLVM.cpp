@@ -1,16 +1,26 @@
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
 
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/SubtargetFeature.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
-#include "llvm/Support/TargetRegistry.h"
+#include "llvm/MC/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
 
 #include "../Builder/NameMangle.hpp"
+#include "../Utils/KeyExistsInMap.hpp"
+#include "../Utils/PhaseTimer.hpp"
 
 #include "SetupLLVM.hpp"
 
@@ -45,35 +55,177 @@ Reloc::Model getRelocModel(translator::Platform platform)
     return platformRelocMap.at(platform);
 }
 
-void initializeTargetRegistry()
+CodeGenOpt::Level getCodeGenOptLevel(translator::OptimizationLevel optimizationLevel)
 {
-    InitializeAllTargetInfos();
-    InitializeAllTargets();
-    InitializeAllTargetMCs();
-    InitializeAllAsmParsers();
-    InitializeAllAsmPrinters();
+    std::map<translator::OptimizationLevel, CodeGenOpt::Level> codeGenOptLevelMap = {
+        { translator::O0, CodeGenOpt::None },    { translator::O1, CodeGenOpt::Less },
+        { translator::O2, CodeGenOpt::Default }, { translator::O3, CodeGenOpt::Aggressive },
+        { translator::Os, CodeGenOpt::Default }, { translator::Oz, CodeGenOpt::Default },
+    };
+
+    return codeGenOptLevelMap.at(optimizationLevel);
+}
+
+std::string getTargetCPU(const translator::Target& target)
+{
+    if (target.cpu == "")
+        return "generic";
+
+    if (target.cpu == "native")
+        return sys::getHostCPUName().str();
+
+    return target.cpu;
 }
 
-TargetMachine* setupTargetTripleAndDataLayout(const ModuleContext& ctx,
-                                              const std::string& targetTriple,
-                                              llvm::Reloc::Model relocModel)
+std::string getTargetFeatures(const translator::Target& target)
+{
+    if (target.cpu != "native")
+        return target.features;
+
+    StringMap<bool> hostFeatures;
+    SubtargetFeatures features;
+
+    if (sys::getHostCPUFeatures(hostFeatures))
+        for (const auto& feature : hostFeatures)
+            features.AddFeature(feature.first(), feature.second);
+
+    /* Features given explicitly come last so they override the host features */
+    if (target.features != "")
+        features.AddFeature(target.features);
+
+    return features.getString();
+}
+
+/* Backend name of each target LLVM was built with, to the functions that register it */
+
+#define LLVM_TARGET(TargetName)                                                                                        \
+    { #TargetName,                                                                                                     \
+      []()                                                                                                             \
+      {                                                                                                                \
+          LLVMInitialize##TargetName##Target();                                                                        \
+          LLVMInitialize##TargetName##TargetMC();                                                                      \
+      } },
+
+static const std::map<std::string, void (*)()> targetInitializers = {
+#include "llvm/Config/Targets.def"
+};
+
+#define LLVM_ASM_PRINTER(TargetName) { #TargetName, LLVMInitialize##TargetName##AsmPrinter },
+
+static const std::map<std::string, void (*)()> asmPrinterInitializers = {
+#include "llvm/Config/AsmPrinters.def"
+};
+
+#define LLVM_ASM_PARSER(TargetName) { #TargetName, LLVMInitialize##TargetName##AsmParser },
+
+static const std::map<std::string, void (*)()> asmParserInitializers = {
+#include "llvm/Config/AsmParsers.def"
+};
+
+const Target* initializeTarget(const ModuleContext& ctx, const std::string& targetTriple)
 {
+    /* Target infos only add the names of targets to the registry, so all of them are registered to
+        find the backend for the triple. The backend itself is registered only when first used */
+
+    static std::once_flag targetInfosInitialized;
+    static std::mutex initializedBackendsMutex;
+    static std::set<std::string> initializedBackends;
+
+    std::call_once(targetInfosInitialized, []() { InitializeAllTargetInfos(); });
+
     std::string error;
-    auto Target = TargetRegistry::lookupTarget(targetTriple, error);
+    const Target* LLVMTarget = TargetRegistry::lookupTarget(targetTriple, error);
 
-    if (!Target)
+    if (!LLVMTarget)
         ctx.console.internalBugErrorMessage("LLVM ERROR: " + error);
 
-    std::string CPU = "generic";
-    std::string features = "";
+    const std::string backendName = LLVMTarget->getBackendName();
+
+    std::lock_guard<std::mutex> lock(initializedBackendsMutex);
+
+    if (initializedBackends.insert(backendName).second)
+    {
+        for (const auto* initializers : { &targetInitializers, &asmPrinterInitializers, &asmParserInitializers })
+            if (keyExistsInMap(*initializers, backendName))
+                initializers->at(backendName)();
+    }
+
+    return LLVMTarget;
+}
+
+std::unique_ptr<TargetMachine> createTargetMachine(const ModuleContext& ctx,
+                                                   const translator::Target& target,
+                                                   CodeGenOpt::Level codeGenOptLevel)
+{
+    const std::string targetTriple = getTargetTriple(target.platform);
+    const Target* LLVMTarget = initializeTarget(ctx, targetTriple);
+
+    std::string CPU = getTargetCPU(target);
+    std::string features = getTargetFeatures(target);
+
+    std::unique_ptr<MCSubtargetInfo> subtargetInfo(LLVMTarget->createMCSubtargetInfo(targetTriple, "generic", ""));
+
+    if (!subtargetInfo->isCPUStringValid(CPU))
+        ctx.console.internalBugErrorMessage("LLVM ERROR: Unknown CPU " + CPU + " for target " + targetTriple);
 
     TargetOptions opt;
-    auto RM = Optional<Reloc::Model>(relocModel);
-    auto targetMachine = Target->createTargetMachine(targetTriple, CPU, features, opt, RM);
+    auto RM = Optional<Reloc::Model>(getRelocModel(target.platform));
+
+    return std::unique_ptr<TargetMachine>(
+        LLVMTarget->createTargetMachine(targetTriple, CPU, features, opt, RM, None, codeGenOptLevel));
+}
+
+/* Creating a TargetMachine is expensive, so they are kept for the next module with the same target. A
+    TargetMachine is not safe to use from multiple threads at once, so a module takes a machine out
+    of the pool while optimizing and emitting and puts it back after, parallel jobs create at most
+    one machine each */
 
-    ctx.LLVMModule->setDataLayout(targetMachine->createDataLayout());
+static std::mutex targetMachinePoolMutex;
+static std::map<std::string, std::vector<std::unique_ptr<TargetMachine>>> targetMachinePool;
 
-    return targetMachine;
+std::string getTargetMachineKey(const translator::Target& target, CodeGenOpt::Level codeGenOptLevel)
+{
+    return getTargetTriple(target.platform) + " " + target.cpu + " " + target.features + " " +
+           std::to_string(codeGenOptLevel);
+}
+
+std::unique_ptr<TargetMachine> acquireTargetMachine(const ModuleContext& ctx,
+                                                    const translator::Target& target,
+                                                    translator::OptimizationLevel optimizationLevel)
+{
+    const CodeGenOpt::Level codeGenOptLevel = getCodeGenOptLevel(optimizationLevel);
+
+    {
+        std::lock_guard<std::mutex> lock(targetMachinePoolMutex);
+
+        std::vector<std::unique_ptr<TargetMachine>>& targetMachines =
+            targetMachinePool[getTargetMachineKey(target, codeGenOptLevel)];
+
+        if (targetMachines.size() != 0)
+        {
+            std::unique_ptr<TargetMachine> targetMachine = std::move(targetMachines.back());
+            targetMachines.pop_back();
+            return targetMachine;
+        }
+    }
+
+    return createTargetMachine(ctx, target, codeGenOptLevel);
+}
+
+void releaseTargetMachine(const translator::Target& target,
+                          translator::OptimizationLevel optimizationLevel,
+                          std::unique_ptr<TargetMachine> targetMachine)
+{
+    std::lock_guard<std::mutex> lock(targetMachinePoolMutex);
+    targetMachinePool[getTargetMachineKey(target, getCodeGenOptLevel(optimizationLevel))].push_back(
+        std::move(targetMachine));
+}
+
+void setModuleTarget(ModuleContext& ctx, const TargetMachine& targetMachine)
+{
+    /* Set before optimizing, so the cost models and the vectorizers see the CPU and its features */
+    ctx.LLVMModule->setTargetTriple(targetMachine.getTargetTriple().str());
+    ctx.LLVMModule->setDataLayout(targetMachine.createDataLayout());
 }
 
 std::string createDirsAndGetOutputObjNameStatic(const std::string& moduleName)
@@ -84,19 +236,32 @@ std::string createDirsAndGetOutputObjNameStatic(const std::string& moduleName)
     const std::filesystem::path objDir("_obj");
     const std::filesystem::path objPath = objDir / objFileName;
 
-    std::filesystem::create_directory(objDir);
+    std::error_code ec;
+    std::filesystem::create_directory(objDir, ec);
 
     return objPath.string();
 }
 
-void setupPassManagerAndCreateObject(ModuleContext& ctx, translator::Platform platform)
+std::string createDirsAndGetLTOObjName(const std::string& moduleName)
 {
-    Reloc::Model relocModel = getRelocModel(platform);
-    std::string targetTriple = getTargetTriple(platform);
+    /* Kept apart from the objects of the modules, so a whole program object is never linked with
+        the objects an earlier -c, -release or -cache build left in _obj, they define the same symbols */
+
+    std::filesystem::path objFileName(mangleModuleName(moduleName));
+    objFileName += ".o";
+
+    const std::filesystem::path objDir = std::filesystem::path("_obj") / "_lto";
+    const std::filesystem::path objPath = objDir / objFileName;
 
-    TargetMachine* targetMachine = setupTargetTripleAndDataLayout(ctx, targetTriple, relocModel);
+    std::error_code ec;
+    std::filesystem::create_directories(objDir, ec);
 
-    std::string filename = createDirsAndGetOutputObjNameStatic(ctx.moduleDescription.name);
+    return objPath.string();
+}
+
+void setupPassManagerAndCreateObject(ModuleContext& ctx, TargetMachine& targetMachine, const std::string& filename)
+{
+    timer::ScopedPhase phase("Object emission", ctx.moduleDescription.name);
 
     std::error_code EC;
     raw_fd_ostream dest(filename, EC, sys::fs::OF_None);
@@ -107,7 +272,7 @@ void setupPassManagerAndCreateObject(ModuleContext& ctx, translator::Platform pl
     legacy::PassManager pass;
     llvm::CodeGenFileType FileType = CGFT_ObjectFile;
 
-    if (targetMachine->addPassesToEmitFile(pass, dest, nullptr, FileType))
+    if (targetMachine.addPassesToEmitFile(pass, dest, nullptr, FileType))
         ctx.console.internalBugErrorMessage("LLVM ERROR: LLVM target machine can't emit a file of this type");
 
     pass.run(*ctx.LLVMModule);
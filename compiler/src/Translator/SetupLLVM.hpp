@@ -1,15 +1,31 @@
 #ifndef TRANSLATOR_LLVM_SETUP
 #define TRANSLATOR_LLVM_SETUP
 
+#include <memory>
 #include <string>
 
 #include "llvm/Target/TargetMachine.h"
 
 #include "ModuleContext.hpp"
-#include "Platform.hpp"
+#include "OptimizationLevel.hpp"
+#include "Target.hpp"
+
+std::string getTargetTriple(translator::Platform platform);
+std::string getTargetCPU(const translator::Target& target);
+std::string getTargetFeatures(const translator::Target& target);
+std::string createDirsAndGetOutputObjNameStatic(const std::string& moduleName);
+std::string createDirsAndGetLTOObjName(const std::string& moduleName);
+
+std::unique_ptr<llvm::TargetMachine> acquireTargetMachine(const ModuleContext& ctx,
+                                                          const translator::Target& target,
+                                                          translator::OptimizationLevel optimizationLevel);
+void releaseTargetMachine(const translator::Target& target,
+                          translator::OptimizationLevel optimizationLevel,
+                          std::unique_ptr<llvm::TargetMachine> targetMachine);
+void setModuleTarget(ModuleContext& ctx, const llvm::TargetMachine& targetMachine);
 
-void initializeTargetRegistry();
 void setupPassManagerAndCreateObject(ModuleContext& ctx,
-                                     translator::Platform platform);
+                                     llvm::TargetMachine& targetMachine,
+                                     const std::string& filename);
 
 #endif
\ No newline at end of file
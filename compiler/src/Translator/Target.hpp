@@ -0,0 +1,28 @@
+#ifndef TRANSLATOR_TARGET
+#define TRANSLATOR_TARGET
+
+#include <string>
+
+#include "Platform.hpp"
+
+namespace translator
+{
+    struct Target
+    {
+        Platform platform = DEFAULT;
+
+        /* Empty for generic CPU, "native" for the host CPU and its features */
+        std::string cpu;
+
+        /* Comma separated list of features to enable or disable, like +avx2,-fma */
+        std::string features;
+
+        /* Instrument optimized modules to write an execution profile when the executable is run */
+        bool profileGenerate = false;
+
+        /* Indexed profile (.profdata) used to guide optimizations, empty for none */
+        std::string profileUseFileName;
+    };
+}
+
+#endif
@@ -77,8 +77,8 @@ Type* typeDescriptionToLLVMType(const ModuleContext& ctx, const icode::TypeDescr
 {
     if (typeDescription.isStruct())
     {
-        icode::StructDescription structDescription =
-            ctx.modulesMap[typeDescription.moduleName].structures[typeDescription.dtypeName];
+        const icode::StructDescription& structDescription =
+            ctx.modulesMap.at(typeDescription.moduleName).structures.at(typeDescription.dtypeName);
 
         icode::DataType dtype = structDescription.getFirstFieldDataType();
 
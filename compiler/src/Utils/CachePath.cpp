@@ -0,0 +1,18 @@
+#include <cstdlib>
+#include <filesystem>
+
+#include "../config.hpp"
+
+#include "CachePath.hpp"
+
+namespace fs = std::filesystem;
+
+std::string getCacheDirectory()
+{
+    const char* cachePath = getenv(CACHE_PATH_ENV_NAME);
+
+    if (cachePath != nullptr)
+        return cachePath;
+
+    return (fs::path("_obj") / "_cache").string();
+}
@@ -0,0 +1,8 @@
+#ifndef UTILS_CACHE_PATH
+#define UTILS_CACHE_PATH
+
+#include <string>
+
+std::string getCacheDirectory();
+
+#endif
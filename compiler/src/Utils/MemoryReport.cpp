@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+#include "llvm/IR/Module.h"
+
+#include "../IntermediateRepresentation/TypeTable.hpp"
+#include "../Source/SourceManager.hpp"
+
+#include "PhaseTimer.hpp"
+
+#include "MemoryReport.hpp"
+
+namespace memory
+{
+    struct ModuleMemory
+    {
+        size_t astNodes = 0;
+        size_t astBytes = 0;
+        size_t icodeEntries = 0;
+        size_t icodeBytes = 0;
+        size_t typeDescriptions = 0;
+        size_t typeDescriptionBytes = 0;
+        size_t LLVMBytes = 0;
+
+        size_t getTotalBytes() const
+        {
+            return astBytes + icodeBytes + typeDescriptionBytes + LLVMBytes;
+        }
+    };
+
+    struct OperandNameCount
+    {
+        std::string name;
+        size_t count;
+    };
+
+    static bool enabled = false;
+
+    static std::mutex modulesMemoryMutex;
+    static std::map<std::string, ModuleMemory> modulesMemory;
+    static std::vector<OperandNameCount> operandNameCounts;
+
+    void enable()
+    {
+        enabled = true;
+    }
+
+    bool isEnabled()
+    {
+        return enabled;
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(modulesMemoryMutex);
+
+        enabled = false;
+        modulesMemory.clear();
+        operandNameCounts.clear();
+    }
+
+    long getCurrentRSS()
+    {
+#ifdef __APPLE__
+        mach_task_basic_info info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+            return 0;
+
+        return info.resident_size;
+#else
+        /* Second field of statm is the number of resident pages */
+        std::ifstream statm("/proc/self/statm");
+
+        long totalPages = 0;
+        long residentPages = 0;
+        statm >> totalPages >> residentPages;
+
+        return residentPages * sysconf(_SC_PAGESIZE);
+#endif
+    }
+
+    long getPeakRSS()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+        return usage.ru_maxrss;
+#else
+        /* Linux reports in kilobytes */
+        return usage.ru_maxrss * 1024;
+#endif
+    }
+
+    size_t getStringHeapBytes(size_t size)
+    {
+        /* Short strings are stored inside the std::string object itself */
+        static const size_t inlineCapacity = std::string().capacity();
+
+        return size > inlineCapacity ? size + 1 : 0;
+    }
+
+    size_t getStringHeapBytes(const std::string& str)
+    {
+        return getStringHeapBytes(str.capacity());
+    }
+
+    void recordAST(const std::string& moduleName, const AST& ast)
+    {
+        if (!enabled)
+            return;
+
+        std::lock_guard<std::mutex> lock(modulesMemoryMutex);
+
+        ModuleMemory& moduleMemory = modulesMemory[moduleName];
+        moduleMemory.astNodes += ast.getNodeCount();
+        moduleMemory.astBytes += ast.getArenaBytes();
+    }
+
+    void addTypeDescriptionMemory(const icode::TypeDescription& type, ModuleMemory& moduleMemory)
+    {
+        moduleMemory.typeDescriptions += 1;
+        moduleMemory.typeDescriptionBytes += sizeof(icode::TypeDescription) + getStringHeapBytes(type.dtypeName) +
+                                             getStringHeapBytes(type.moduleName) +
+                                             type.dimensions.capacity() * sizeof(int) +
+                                             type.dimTypes.capacity() * sizeof(icode::DimensionType);
+    }
+
+    void addFunctionMemory(const icode::FunctionDescription& function,
+                           ModuleMemory& moduleMemory,
+                           std::unordered_map<std::string, size_t>& operandNames)
+    {
+        addTypeDescriptionMemory(function.functionReturnType, moduleMemory);
+
+        for (const auto& symbol : function.symbols)
+            addTypeDescriptionMemory(symbol.second, moduleMemory);
+
+        moduleMemory.icodeEntries += function.icodeTable.size();
+        moduleMemory.icodeBytes += function.icodeTable.capacity() * sizeof(icode::Entry);
+
+        for (const icode::Entry& e : function.icodeTable)
+        {
+            for (const icode::Operand* op : { &e.op1, &e.op2, &e.op3 })
+            {
+                if (op->name == icode::EMPTY_SYMBOL)
+                    continue;
+
+                operandNames[icode::symbolName(op->name)] += 1;
+            }
+        }
+    }
+
+    void recordModules(const icode::StringModulesMap& modulesMap)
+    {
+        if (!enabled)
+            return;
+
+        std::lock_guard<std::mutex> lock(modulesMemoryMutex);
+
+        std::unordered_map<std::string, size_t> operandNames;
+
+        for (const auto& stringModulePair : modulesMap)
+        {
+            const icode::ModuleDescription& module = stringModulePair.second;
+            ModuleMemory& moduleMemory = modulesMemory[stringModulePair.first];
+
+            moduleMemory.icodeEntries = 0;
+            moduleMemory.icodeBytes = 0;
+            moduleMemory.typeDescriptions = 0;
+            moduleMemory.typeDescriptionBytes = 0;
+
+            for (const auto& function : module.functions)
+                addFunctionMemory(function.second, moduleMemory, operandNames);
+
+            for (const auto& function : module.externFunctions)
+                addFunctionMemory(function.second, moduleMemory, operandNames);
+
+            for (const auto& structure : module.structures)
+                for (const auto& field : structure.second.structFields)
+                    addTypeDescriptionMemory(field.second, moduleMemory);
+
+            for (const auto& global : module.globals)
+                addTypeDescriptionMemory(global.second, moduleMemory);
+        }
+
+        operandNameCounts.clear();
+
+        for (const auto& operandNamePair : operandNames)
+            operandNameCounts.push_back(OperandNameCount{ operandNamePair.first, operandNamePair.second });
+
+        std::sort(operandNameCounts.begin(),
+                  operandNameCounts.end(),
+                  [](const OperandNameCount& a, const OperandNameCount& b)
+                  { return a.count > b.count || (a.count == b.count && a.name < b.name); });
+    }
+
+    void recordLLVMModule(const std::string& moduleName, const llvm::Module& LLVMModule)
+    {
+        /* Constants and types are owned by the LLVMContext and not counted */
+
+        if (!enabled)
+            return;
+
+        size_t bytes = sizeof(llvm::Module);
+
+        for (const llvm::GlobalVariable& global : LLVMModule.globals())
+            bytes += sizeof(llvm::GlobalVariable) + global.getNumOperands() * sizeof(llvm::Use);
+
+        for (const llvm::Function& function : LLVMModule)
+        {
+            bytes += sizeof(llvm::Function) + function.arg_size() * sizeof(llvm::Argument);
+
+            for (const llvm::BasicBlock& block : function)
+            {
+                bytes += sizeof(llvm::BasicBlock);
+
+                for (const llvm::Instruction& instruction : block)
+                    bytes += sizeof(llvm::Instruction) + instruction.getNumOperands() * sizeof(llvm::Use);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(modulesMemoryMutex);
+        modulesMemory[moduleName].LLVMBytes += bytes;
+    }
+
+    std::string formatKilobytes(long bytes)
+    {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(2) << bytes / 1024.0;
+        return stream.str();
+    }
+
+    void printPhaseTable()
+    {
+        const std::vector<std::pair<std::string, long>> phaseRSSGrowth = timer::getPhaseRSSGrowth();
+
+        size_t nameWidth = std::string("Phase").size();
+
+        for (const auto& phase : phaseRSSGrowth)
+            nameWidth = std::max(nameWidth, phase.first.size());
+
+        nameWidth += 2;
+
+        std::cout << std::left << std::setw(nameWidth) << "Phase" << std::right << std::setw(20) << "RSS growth (KB)"
+                  << std::endl;
+
+        long total = 0;
+
+        for (const auto& phase : phaseRSSGrowth)
+        {
+            std::cout << std::left << std::setw(nameWidth) << phase.first << std::right << std::setw(20)
+                      << formatKilobytes(phase.second) << std::endl;
+
+            total += phase.second;
+        }
+
+        std::cout << std::left << std::setw(nameWidth) << "Total" << std::right << std::setw(20)
+                  << formatKilobytes(total) << std::endl;
+    }
+
+    void printModuleRow(const std::string& name, size_t nameWidth, const ModuleMemory& moduleMemory)
+    {
+        std::cout << std::left << std::setw(nameWidth) << name << std::right << std::setw(12) << moduleMemory.astNodes
+                  << std::setw(12) << formatKilobytes(moduleMemory.astBytes) << std::setw(12)
+                  << moduleMemory.icodeEntries << std::setw(12) << formatKilobytes(moduleMemory.icodeBytes)
+                  << std::setw(10) << moduleMemory.typeDescriptions << std::setw(12)
+                  << formatKilobytes(moduleMemory.typeDescriptionBytes) << std::setw(12)
+                  << formatKilobytes(moduleMemory.LLVMBytes) << std::endl;
+    }
+
+    void printModuleTable()
+    {
+        std::vector<std::string> moduleNames;
+        size_t nameWidth = std::string("Module").size();
+
+        for (const auto& moduleMemory : modulesMemory)
+        {
+            moduleNames.push_back(moduleMemory.first);
+            nameWidth = std::max(nameWidth, moduleMemory.first.size());
+        }
+
+        nameWidth += 2;
+
+        std::stable_sort(moduleNames.begin(),
+                         moduleNames.end(),
+                         [](const std::string& a, const std::string& b)
+                         { return modulesMemory.at(a).getTotalBytes() > modulesMemory.at(b).getTotalBytes(); });
+
+        std::cout << std::left << std::setw(nameWidth) << "Module" << std::right << std::setw(12) << "AST nodes"
+                  << std::setw(12) << "AST (KB)" << std::setw(12) << "Entries"
+                  << std::setw(12) << "icode (KB)" << std::setw(10) << "Types" << std::setw(12) << "Types (KB)"
+                  << std::setw(12) << "LLVM (KB)" << std::endl;
+
+        ModuleMemory total;
+
+        for (const std::string& moduleName : moduleNames)
+        {
+            const ModuleMemory& moduleMemory = modulesMemory.at(moduleName);
+
+            printModuleRow(moduleName, nameWidth, moduleMemory);
+
+            total.astNodes += moduleMemory.astNodes;
+            total.astBytes += moduleMemory.astBytes;
+            total.icodeEntries += moduleMemory.icodeEntries;
+            total.icodeBytes += moduleMemory.icodeBytes;
+            total.typeDescriptions += moduleMemory.typeDescriptions;
+            total.typeDescriptionBytes += moduleMemory.typeDescriptionBytes;
+            total.LLVMBytes += moduleMemory.LLVMBytes;
+        }
+
+        printModuleRow("Total", nameWidth, total);
+    }
+
+    void printOperandNames()
+    {
+        size_t totalNames = 0;
+        size_t internedBytes = 0;
+
+        for (const OperandNameCount& operandName : operandNameCounts)
+        {
+            totalNames += operandName.count;
+            internedBytes += sizeof(std::string) + getStringHeapBytes(operandName.name);
+        }
+
+        /* Operands hold symbol ids, each name is stored once in the symbol table */
+        std::cout << "Operand names: " << totalNames << " in icode, " << operandNameCounts.size() << " unique, "
+                  << "interned in " << formatKilobytes(internedBytes) << " KB" << std::endl;
+
+        const size_t shownNames = std::min(operandNameCounts.size(), (size_t)10);
+
+        if (shownNames == 0)
+            return;
+
+        std::cout << "Most duplicated operand names:" << std::endl;
+
+        for (size_t i = 0; i < shownNames; i += 1)
+            std::cout << "    " << std::left << std::setw(40) << operandNameCounts[i].name << std::right
+                      << std::setw(10) << operandNameCounts[i].count << std::endl;
+    }
+
+    void printReport()
+    {
+        std::lock_guard<std::mutex> lock(modulesMemoryMutex);
+
+        std::cout << "Peak RSS: " << formatKilobytes(getPeakRSS()) << " KB" << std::endl;
+
+        /* Token strings point into these instead of being allocated per token */
+        std::cout << "Mapped source files: " << formatKilobytes(source::getMappedBytes()) << " KB" << std::endl;
+        std::cout << "Interned token strings: " << formatKilobytes(source::getInternedStringBytes()) << " KB"
+                  << std::endl;
+        std::cout << "Interned IR names: " << icode::getSymbolsCount() << ", types: " << icode::getTypesCount()
+                  << std::endl;
+        std::cout << std::endl;
+        printPhaseTable();
+        std::cout << std::endl;
+        printModuleTable();
+        std::cout << std::endl;
+        printOperandNames();
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef UTILS_MEMORY_REPORT
+#define UTILS_MEMORY_REPORT
+
+#include <string>
+
+#include "../IntermediateRepresentation/All.hpp"
+#include "../Node/AST.hpp"
+
+namespace llvm
+{
+    class Module;
+}
+
+namespace memory
+{
+    void enable();
+
+    bool isEnabled();
+
+    /* Disables the memory report and discards everything recorded so far */
+    void reset();
+
+    long getCurrentRSS();
+
+    long getPeakRSS();
+
+    /* The record functions estimate the bytes held by a data structure, counting the heap memory of
+        containers and strings but not allocator overhead. They do nothing unless the report is enabled */
+
+    void recordAST(const std::string& moduleName, const AST& ast);
+
+    void recordModules(const icode::StringModulesMap& modulesMap);
+
+    void recordLLVMModule(const std::string& moduleName, const llvm::Module& LLVMModule);
+
+    void printReport();
+}
+
+#endif
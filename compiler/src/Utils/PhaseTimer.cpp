@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "MemoryReport.hpp"
+
+#include "PhaseTimer.hpp"
+
+namespace timer
+{
+    struct PhaseRecord
+    {
+        const char* phaseName;
+        std::string moduleName;
+        unsigned int threadId;
+        double startWallTime;
+        double wallTime;
+        double selfWallTime;
+        double selfCPUTime;
+        long selfRSSGrowth;
+    };
+
+    struct PhaseTotal
+    {
+        double wallTime = 0;
+        double cpuTime = 0;
+    };
+
+    static bool enabled = false;
+
+    static std::mutex recordsMutex;
+    static std::vector<PhaseRecord> records;
+    static std::vector<std::string> phaseOrder;
+
+    static std::atomic<unsigned int> threadCount(0);
+    static thread_local unsigned int threadId = threadCount++;
+    static thread_local ScopedPhase* currentPhase = nullptr;
+
+    static const auto processStartTime = std::chrono::steady_clock::now();
+
+    double getWallTime()
+    {
+        /* Microseconds since the compiler started */
+        const auto elapsed = std::chrono::steady_clock::now() - processStartTime;
+        return std::chrono::duration<double, std::micro>(elapsed).count();
+    }
+
+    double getThreadCPUTime()
+    {
+        timespec time;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return time.tv_sec * 1e6 + time.tv_nsec / 1e3;
+    }
+
+    void enable()
+    {
+        enabled = true;
+    }
+
+    bool isEnabled()
+    {
+        return enabled;
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+
+        enabled = false;
+        records.clear();
+        phaseOrder.clear();
+    }
+
+    ScopedPhase::ScopedPhase(const char* phaseName, const std::string& moduleName)
+        : phaseName(phaseName)
+        , childWallTime(0)
+        , childCPUTime(0)
+        , startRSS(0)
+        , childRSSGrowth(0)
+        , parent(nullptr)
+    {
+        if (!enabled)
+            return;
+
+        this->moduleName = moduleName;
+
+        parent = currentPhase;
+        currentPhase = this;
+
+        startWallTime = getWallTime();
+        startCPUTime = getThreadCPUTime();
+
+        if (memory::isEnabled())
+            startRSS = memory::getCurrentRSS();
+    }
+
+    ScopedPhase::~ScopedPhase()
+    {
+        if (!enabled)
+            return;
+
+        const double wallTime = getWallTime() - startWallTime;
+        const double cpuTime = getThreadCPUTime() - startCPUTime;
+        const long rssGrowth = memory::isEnabled() ? memory::getCurrentRSS() - startRSS : 0;
+
+        currentPhase = parent;
+
+        if (parent != nullptr)
+        {
+            parent->childWallTime += wallTime;
+            parent->childCPUTime += cpuTime;
+            parent->childRSSGrowth += rssGrowth;
+        }
+
+        PhaseRecord record{ phaseName,
+                            moduleName,
+                            threadId,
+                            startWallTime,
+                            wallTime,
+                            wallTime - childWallTime,
+                            cpuTime - childCPUTime,
+                            rssGrowth - childRSSGrowth };
+
+        std::lock_guard<std::mutex> lock(recordsMutex);
+
+        if (std::find(phaseOrder.begin(), phaseOrder.end(), phaseName) == phaseOrder.end())
+            phaseOrder.push_back(phaseName);
+
+        records.push_back(record);
+    }
+
+    std::string formatMilliseconds(double microseconds)
+    {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(2) << microseconds / 1000;
+        return stream.str();
+    }
+
+    void printRow(const std::string& name, size_t nameWidth, const PhaseTotal& total)
+    {
+        std::cout << std::left << std::setw(nameWidth) << name << std::right << std::setw(14)
+                  << formatMilliseconds(total.wallTime) << std::setw(14) << formatMilliseconds(total.cpuTime)
+                  << std::endl;
+    }
+
+    void printTable(const std::string& title,
+                    const std::vector<std::string>& names,
+                    const std::map<std::string, PhaseTotal>& totals)
+    {
+        size_t nameWidth = title.size();
+
+        for (const std::string& name : names)
+            nameWidth = std::max(nameWidth, name.size());
+
+        nameWidth += 2;
+
+        std::cout << std::left << std::setw(nameWidth) << title << std::right << std::setw(14) << "Wall (ms)"
+                  << std::setw(14) << "CPU (ms)" << std::endl;
+
+        PhaseTotal grandTotal;
+
+        for (const std::string& name : names)
+        {
+            printRow(name, nameWidth, totals.at(name));
+
+            grandTotal.wallTime += totals.at(name).wallTime;
+            grandTotal.cpuTime += totals.at(name).cpuTime;
+        }
+
+        printRow("Total", nameWidth, grandTotal);
+    }
+
+    void printSummary()
+    {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+
+        std::map<std::string, PhaseTotal> phaseTotals;
+        std::map<std::string, PhaseTotal> moduleTotals;
+
+        for (const PhaseRecord& record : records)
+        {
+            phaseTotals[record.phaseName].wallTime += record.selfWallTime;
+            phaseTotals[record.phaseName].cpuTime += record.selfCPUTime;
+            moduleTotals[record.moduleName].wallTime += record.selfWallTime;
+            moduleTotals[record.moduleName].cpuTime += record.selfCPUTime;
+        }
+
+        std::vector<std::string> moduleNames;
+
+        for (const auto& moduleTotal : moduleTotals)
+            moduleNames.push_back(moduleTotal.first);
+
+        std::stable_sort(moduleNames.begin(),
+                         moduleNames.end(),
+                         [&](const std::string& a, const std::string& b)
+                         { return moduleTotals.at(a).wallTime > moduleTotals.at(b).wallTime; });
+
+        printTable("Phase", phaseOrder, phaseTotals);
+        std::cout << std::endl;
+        printTable("Module", moduleNames, moduleTotals);
+    }
+
+    std::vector<std::pair<std::string, long>> getPhaseRSSGrowth()
+    {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+
+        std::map<std::string, long> phaseRSSGrowth;
+
+        for (const PhaseRecord& record : records)
+            phaseRSSGrowth[record.phaseName] += record.selfRSSGrowth;
+
+        std::vector<std::pair<std::string, long>> orderedPhaseRSSGrowth;
+
+        for (const std::string& phaseName : phaseOrder)
+            orderedPhaseRSSGrowth.push_back({ phaseName, phaseRSSGrowth.at(phaseName) });
+
+        return orderedPhaseRSSGrowth;
+    }
+
+    std::string escapeJSONString(const std::string& str)
+    {
+        std::string escaped;
+
+        for (const char c : str)
+        {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+
+            escaped += c;
+        }
+
+        return escaped;
+    }
+
+    bool writeChromeTrace(const std::string& fileName)
+    {
+        /* Written in the trace event format, open using chrome://tracing or https://ui.perfetto.dev */
+
+        std::lock_guard<std::mutex> lock(recordsMutex);
+
+        std::ofstream file(fileName);
+
+        file << "{\"traceEvents\":[";
+
+        for (size_t i = 0; i < records.size(); i += 1)
+        {
+            const PhaseRecord& record = records[i];
+
+            if (i != 0)
+                file << ",";
+
+            file << "\n{\"name\":\"" << record.phaseName << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << record.threadId
+                 << std::fixed << std::setprecision(3) << ",\"ts\":" << record.startWallTime
+                 << ",\"dur\":" << record.wallTime << ",\"args\":{\"module\":\""
+                 << escapeJSONString(record.moduleName) << "\"}}";
+        }
+
+        file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        file.close();
+
+        return !file.fail();
+    }
+}
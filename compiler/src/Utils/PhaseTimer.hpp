@@ -0,0 +1,49 @@
+#ifndef UTILS_PHASE_TIMER
+#define UTILS_PHASE_TIMER
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace timer
+{
+    void enable();
+
+    bool isEnabled();
+
+    /* Disables the timer and discards all phases recorded so far */
+    void reset();
+
+    /* Records the wall and CPU time from construction to destruction as one phase of a module.
+        Time spent in phases nested inside this one (generating a used module for example) is
+        not counted towards this phase in the summary */
+    class ScopedPhase
+    {
+        const char* phaseName;
+        std::string moduleName;
+
+        double startWallTime;
+        double startCPUTime;
+        double childWallTime;
+        double childCPUTime;
+
+        long startRSS;
+        long childRSSGrowth;
+
+        ScopedPhase* parent;
+
+    public:
+        ScopedPhase(const char* phaseName, const std::string& moduleName);
+        ~ScopedPhase();
+    };
+
+    void printSummary();
+
+    /* Growth of the resident set size in bytes during each phase, excluding nested phases.
+        Only recorded when the memory report is enabled */
+    std::vector<std::pair<std::string, long>> getPhaseRSSGrowth();
+
+    bool writeChromeTrace(const std::string& fileName);
+}
+
+#endif
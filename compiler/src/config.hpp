@@ -7,5 +7,6 @@
 
 #define DEFAULT_LIB_PATH "/usr/local/lib/"
 #define SHNOOTALK_PATH_ENV_NAME "SHNOOTALK_PATH"
+#define CACHE_PATH_ENV_NAME "SHNOOTALK_CACHE_PATH"
 
 #endif
\ No newline at end of file
@@ -1,13 +1,19 @@
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 #include "Console/Console.hpp"
+#include "Generator/FunctionDemand.hpp"
 #include "Generator/IRGenerator.hpp"
+#include "IntermediateRepresentation/TypeTable.hpp"
 #include "PrettyPrint/ASTPrinter.hpp"
 #include "PrettyPrint/IRPrinter.hpp"
 #include "PrettyPrint/PrettyPrintError.hpp"
 #include "Translator/LLVMTranslator.hpp"
 #include "Utils/KeyExistsInMap.hpp"
+#include "Utils/MemoryReport.hpp"
+#include "Utils/PhaseTimer.hpp"
 
 #include "config.hpp"
 
@@ -20,13 +26,19 @@ static std::map<std::string, translator::Platform> platformMap = {
     { "-wasm64", translator::WASM64 },
 };
 
+static std::map<std::string, translator::OptimizationLevel> optimizationLevelMap = {
+    { "-O0", translator::O0 }, { "-O1", translator::O1 }, { "-O2", translator::O2 },
+    { "-O3", translator::O3 }, { "-Os", translator::Os }, { "-Oz", translator::Oz },
+};
+
 void printCLIUsage()
 {
-    pp::println("USAGE: shtkc FILE OPTION");
+    pp::println("USAGE: shtkc FILE OPTION [ADDITIONAL OPTIONS]");
     pp::println("");
     pp::println("Available options:");
     pp::println("    -c               Create debug executable");
     pp::println("    -release         Create release executable");
+    pp::println("    -release-lto     Create release executable with whole program optimization");
     pp::println("    -ast             Print parse tree");
     pp::println("    -ir              Print ShnooTalk IR");
     pp::println("    -icode           Print ShnooTalk IR, but only the icode");
@@ -42,7 +54,25 @@ void printCLIUsage()
     for (const auto& pair : platformMap)
         pp::println("    " + pair.first);
     pp::println("");
+    pp::println("Additional options for creating executables:");
+    pp::println("    -j N             Generate functions and object files using N parallel jobs");
+    pp::println("    -cache           Reuse cached IR and object files of unchanged modules");
+    pp::println("    -march=native    Generate code for the host CPU and its features");
+    pp::println("    -mcpu=CPU        Generate code for the given CPU");
+    pp::println("    -mattr=FEATURES  Enable or disable target features, like +avx2,-fma");
+    pp::println("    -O0 to -O3       Set optimization level, default is -O0 for debug and -O3 for release");
+    pp::println("    -Os, -Oz         Optimize for size, -Oz more aggressively");
+    pp::println("    -fprofile-generate");
+    pp::println("                     Instrument optimized code to write a profile when run");
+    pp::println("    -fprofile-use=FILE");
+    pp::println("                     Use profile FILE created with llvm-profdata to guide optimization");
+    pp::println("    -time-phases     Print time taken by each compiler phase");
+    pp::println("    -time-trace=FILE Write time taken by each compiler phase to FILE as a Chrome trace");
+    pp::println("    -mem-report      Print peak memory and approximate size of compiler data structures");
+    pp::println("");
     pp::println("Use shtkc -version for compiler version");
+    pp::println("Use shtkc -batch FILE... OPTION [ADDITIONAL OPTIONS] to create executables for many files at once");
+    pp::println("Use shtkc -serve to read compile requests from stdin, one per line");
 }
 
 bool isValidPlatformString(const std::string& platformString)
@@ -55,25 +85,184 @@ translator::Platform getPlatformFromString(const std::string& platformString)
     return platformMap.at(platformString);
 }
 
-int phaseDriver(const std::string& moduleName, const std::string& option, Console& console)
+struct BuildOptions
 {
-    console.pushRootModule(moduleName);
+    unsigned int jobs = 1;
+    bool cache = false;
+    std::string cpu;
+    std::string features;
+    std::string optimizationLevel;
+    bool profileGenerate = false;
+    std::string profileUseFileName;
+    bool timePhases = false;
+    std::string traceFileName;
+    bool memReport = false;
+};
+
+bool startsWith(const std::string& str, const std::string& prefix)
+{
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool parseJobsCount(const std::string& jobsString, unsigned int& jobs)
+{
+    if (jobsString.size() == 0 || jobsString.size() > 4)
+        return false;
+
+    if (!std::all_of(jobsString.begin(), jobsString.end(), ::isdigit))
+        return false;
+
+    jobs = std::stoul(jobsString);
+
+    return jobs > 0;
+}
+
+bool parseBuildOptions(const std::vector<std::string>& flags, BuildOptions& options)
+{
+    for (size_t i = 0; i < flags.size(); i += 1)
+    {
+        const std::string& flag = flags[i];
+
+        if (flag == "-j" && i + 1 < flags.size() && parseJobsCount(flags[i + 1], options.jobs))
+            i += 1;
+        else if (flag == "-cache")
+            options.cache = true;
+        else if (flag == "-march=native")
+            options.cpu = "native";
+        else if (startsWith(flag, "-mcpu=") && flag.size() > 6)
+            options.cpu = flag.substr(6);
+        else if (startsWith(flag, "-mattr=") && flag.size() > 7)
+            options.features = flag.substr(7);
+        else if (keyExistsInMap(optimizationLevelMap, flag))
+            options.optimizationLevel = flag;
+        else if (flag == "-fprofile-generate")
+            options.profileGenerate = true;
+        else if (startsWith(flag, "-fprofile-use=") && flag.size() > 14)
+            options.profileUseFileName = flag.substr(14);
+        else if (flag == "-time-phases")
+            options.timePhases = true;
+        else if (startsWith(flag, "-time-trace=") && flag.size() > 12)
+            options.traceFileName = flag.substr(12);
+        else if (flag == "-mem-report")
+            options.memReport = true;
+        else
+            return false;
+    }
+
+    /* A profile cannot be used by instrumented code */
+    return !options.profileGenerate || options.profileUseFileName == "";
+}
+
+translator::Target getTarget(const std::string& option, const BuildOptions& options)
+{
+    translator::Target target;
+    target.cpu = options.cpu;
+    target.features = options.features;
+    target.profileGenerate = options.profileGenerate;
+    target.profileUseFileName = options.profileUseFileName;
+
+    if (isValidPlatformString(option))
+        target.platform = getPlatformFromString(option);
+
+    return target;
+}
+
+translator::OptimizationLevel getOptimizationLevel(bool release, const BuildOptions& options)
+{
+    if (options.optimizationLevel != "")
+        return optimizationLevelMap.at(options.optimizationLevel);
+
+    return release ? translator::O3 : translator::O0;
+}
+
+bool generatesCode(const std::string& option)
+{
+    /* The IR printing options print every function, the others translate only the demanded ones */
+    return option == "-llvm" || option == "-llvm-release" || option == "-c" || option == "-release" ||
+           option == "-release-lto" || isValidPlatformString(option);
+}
+
+bool isReleaseOption(const std::string& option)
+{
+    return option == "-release" || option == "-release-lto" || option == "-llvm-release" ||
+           isValidPlatformString(option);
+}
+
+bool checkProfileOptions(const std::string& option, const BuildOptions& options)
+{
+    if (!options.profileGenerate && options.profileUseFileName == "")
+        return true;
+
+    /* The profile passes are part of the optimization pipeline, which does not run at -O0 */
+    if (generatesCode(option) && getOptimizationLevel(isReleaseOption(option), options) == translator::O0)
+    {
+        pp::println("Profile options need an optimization level above -O0");
+        return false;
+    }
 
+    if (options.profileUseFileName == "")
+        return true;
+
+    const std::string profileError = translator::getProfileError(options.profileUseFileName);
+
+    if (profileError != "")
+    {
+        pp::println("Could not read profile " + options.profileUseFileName + ": " + profileError);
+        return false;
+    }
+
+    return true;
+}
+
+bool checkLTOOptions(const std::string& option, const BuildOptions& options)
+{
+    /* The whole program is optimized and emitted as one object, so there are no
+        module objects to cache or to emit in parallel */
+    if (option == "-release-lto" && (options.cache || options.jobs > 1))
+    {
+        pp::println("-cache and -j can not be used with -release-lto");
+        return false;
+    }
+
+    return true;
+}
+
+int phaseDriver(const std::string& moduleName,
+                const std::string& option,
+                const BuildOptions& options,
+                Console& console,
+                IRCache& irCache,
+                monomorphizer::StringGenericASTMap& genericsMap)
+{
     if (option == "-ast")
     {
-        pp::printNode(generator::generateAST(console));
+        console.pushRootModule(moduleName);
+        pp::printNode(generator::generateAST(console).getRoot());
         return 0;
     }
 
     if (option == "-json-ast")
     {
-        pp::printJSONAST(generator::generateAST(console));
+        console.pushRootModule(moduleName);
+        pp::printJSONAST(generator::generateAST(console).getRoot());
         return 0;
     }
 
+    const translator::Target target = getTarget(option, options);
+    const translator::OptimizationLevel debugLevel = getOptimizationLevel(false, options);
+    const translator::OptimizationLevel releaseLevel = getOptimizationLevel(true, options);
+
     icode::StringModulesMap modulesMap;
-    monomorphizer::StringGenericASTMap genericsMap;
-    generator::generateIR(console, moduleName, modulesMap, genericsMap);
+    generator::FunctionJobs functionJobs(options.jobs);
+
+    generator::generateIR(console, { moduleName }, irCache, modulesMap, genericsMap, functionJobs);
+
+    console.pushRootModule(moduleName);
+
+    if (generatesCode(option))
+        generator::removeUndemandedFunctions(modulesMap, { moduleName });
+
+    memory::recordModules(modulesMap);
 
     if (option == "-ir")
         pp::printModule(modulesMap[moduleName], false);
@@ -92,26 +281,17 @@ int phaseDriver(const std::string& moduleName, const std::string& option, Consol
     else if (option == "-json-icode-all")
         pp::printModulesMapIcodeOnly(modulesMap, true);
     else if (option == "-llvm")
-        pp::println(translator::generateLLVMModuleString(modulesMap[moduleName], modulesMap, false, console));
+        pp::println(
+            translator::generateLLVMModuleString(modulesMap[moduleName], modulesMap, target, debugLevel, console));
     else if (option == "-llvm-release")
-        pp::println(translator::generateLLVMModuleString(modulesMap[moduleName], modulesMap, true, console));
+        pp::println(
+            translator::generateLLVMModuleString(modulesMap[moduleName], modulesMap, target, releaseLevel, console));
     else if (option == "-c")
-        for (auto stringModulePair : modulesMap)
-            translator::generateObject(stringModulePair.second, modulesMap, translator::DEFAULT, false, console);
-    else if (option == "-release")
-        for (auto stringModulePair : modulesMap)
-            translator::generateObject(stringModulePair.second, modulesMap, translator::DEFAULT, true, console);
-    else if (isValidPlatformString(option))
-    {
-        for (auto stringModulePair : modulesMap)
-        {
-            translator::generateObject(stringModulePair.second,
-                                       modulesMap,
-                                       getPlatformFromString(option),
-                                       true,
-                                       console);
-        }
-    }
+        translator::generateObjects(modulesMap, target, debugLevel, options.jobs, options.cache, console);
+    else if (option == "-release" || isValidPlatformString(option))
+        translator::generateObjects(modulesMap, target, releaseLevel, options.jobs, options.cache, console);
+    else if (option == "-release-lto")
+        translator::generateLTOObject(modulesMap[moduleName], modulesMap, target, releaseLevel, console);
     else
     {
         printCLIUsage();
@@ -122,35 +302,132 @@ int phaseDriver(const std::string& moduleName, const std::string& option, Consol
     return 0;
 }
 
-int main(int argc, char* argv[])
+int batchPhaseDriver(const std::vector<std::string>& moduleNames,
+                     const std::string& option,
+                     const BuildOptions& options,
+                     Console& console,
+                     IRCache& irCache,
+                     monomorphizer::StringGenericASTMap& genericsMap)
 {
-    Console console;
+    /* All root modules share one modules map, so modules used by more than one root module are
+        generated and translated only once. The objects each executable needs are printed at the end */
+
+    const bool release = option == "-release" || isValidPlatformString(option);
 
-    if (argc < 2)
+    if (option != "-c" && !release)
     {
         printCLIUsage();
         return EXIT_FAILURE;
     }
 
-    std::string fileName = argv[1];
+    icode::StringModulesMap modulesMap;
+    generator::FunctionJobs functionJobs(options.jobs);
+
+    generator::generateIR(console, moduleNames, irCache, modulesMap, genericsMap, functionJobs);
+
+    generator::removeUndemandedFunctions(modulesMap, moduleNames);
+    memory::recordModules(modulesMap);
 
-    if (fileName == "-version" && argc == 2)
+    translator::generateObjects(modulesMap,
+                                getTarget(option, options),
+                                getOptimizationLevel(release, options),
+                                options.jobs,
+                                options.cache,
+                                console);
+
+    for (const std::string& moduleName : moduleNames)
     {
-        pp::println(VERSION);
-        return EXIT_SUCCESS;
+        std::string line = moduleName + ":";
+
+        for (const std::string& objectFileName : translator::getObjectFileNames(modulesMap, moduleName))
+            line += " " + objectFileName;
+
+        pp::println(line);
     }
 
-    if (argc != 3)
+    return 0;
+}
+
+void printInstantiationStats()
+{
+    const monomorphizer::InstantiationStats stats = monomorphizer::getInstantiationStats();
+
+    pp::println("");
+    pp::println("Instantiation memo: " + std::to_string(stats.hits) + " hits, " + std::to_string(stats.misses) +
+                " misses");
+}
+
+int compile(const std::vector<std::string>& arguments,
+            IRCache& irCache,
+            monomorphizer::StringGenericASTMap& genericsMap)
+{
+    const bool batch = arguments.size() != 0 && arguments[0] == "-batch";
+
+    std::vector<std::string> fileNames;
+    size_t optionIndex = 0;
+
+    if (batch)
+    {
+        for (optionIndex = 1; optionIndex < arguments.size() && arguments[optionIndex][0] != '-'; optionIndex += 1)
+            fileNames.push_back(arguments[optionIndex]);
+    }
+    else if (arguments.size() != 0)
+    {
+        fileNames.push_back(arguments[0]);
+        optionIndex = 1;
+    }
+
+    if (fileNames.size() == 0 || optionIndex >= arguments.size())
+    {
+        printCLIUsage();
+        return EXIT_FAILURE;
+    }
+
+    const std::string& option = arguments[optionIndex];
+
+    BuildOptions options;
+
+    if (!parseBuildOptions(std::vector<std::string>(arguments.begin() + optionIndex + 1, arguments.end()), options))
     {
         printCLIUsage();
         return EXIT_FAILURE;
     }
 
-    std::string option = argv[2];
+    if (!checkProfileOptions(option, options) || !checkLTOOptions(option, options))
+        return EXIT_FAILURE;
+
+    /* The memory report needs the timer to attribute RSS growth to phases */
+    if (options.timePhases || options.traceFileName != "" || options.memReport)
+        timer::enable();
+
+    if (options.memReport)
+        memory::enable();
+
+    irCache.setEnabled(options.cache);
+
+    Console console;
 
     try
     {
-        return phaseDriver(fileName, option, console);
+        const int exitCode = batch ? batchPhaseDriver(fileNames, option, options, console, irCache, genericsMap)
+                                   : phaseDriver(fileNames[0], option, options, console, irCache, genericsMap);
+
+        if (options.timePhases)
+        {
+            timer::printSummary();
+            printInstantiationStats();
+        }
+
+        if (options.memReport)
+            memory::printReport();
+
+        if (options.traceFileName != "" && !timer::writeChromeTrace(options.traceFileName))
+        {
+            pp::println("File I/O error");
+            return EXIT_FAILURE;
+        }
+
+        return exitCode;
     }
     catch (const CompileError)
     {
@@ -180,3 +457,112 @@ int main(int argc, char* argv[])
 
     return 0;
 }
+
+std::vector<std::string> splitArguments(const std::string& line)
+{
+    std::vector<std::string> arguments;
+    std::istringstream stream(line);
+    std::string argument;
+
+    while (stream >> argument)
+        arguments.push_back(argument);
+
+    return arguments;
+}
+
+void removeChangedGenerics(IRCache& irCache,
+                           monomorphizer::StringGenericASTMap& genericsMap,
+                           std::map<std::string, std::string>& genericHashes)
+{
+    for (auto genericPair = genericsMap.begin(); genericPair != genericsMap.end();)
+    {
+        const std::string hash = irCache.getSourceHash(genericPair->first);
+
+        if (hash == "" || hash != genericHashes[genericPair->first])
+        {
+            genericHashes.erase(genericPair->first);
+            genericPair = genericsMap.erase(genericPair);
+        }
+        else
+            genericPair++;
+    }
+}
+
+void recordGenericHashes(IRCache& irCache,
+                         const monomorphizer::StringGenericASTMap& genericsMap,
+                         std::map<std::string, std::string>& genericHashes)
+{
+    for (const auto& genericPair : genericsMap)
+        if (genericHashes.count(genericPair.first) == 0)
+            genericHashes[genericPair.first] = irCache.getSourceHash(genericPair.first);
+}
+
+int serve()
+{
+    /* Each line read from stdin is one compile request with the same arguments as the command line,
+        the output of a request is followed by the line "shtkc-serve: exit CODE". Used modules and parsed
+        generic modules are kept between requests, and are generated again only when their source
+        files change. Kept modules are serialized, so the names and types interned by a request are
+        freed after it */
+
+    IRCache irCache(false, true);
+    monomorphizer::StringGenericASTMap genericsMap;
+    std::map<std::string, std::string> genericHashes;
+
+    std::string line;
+
+    while (std::getline(std::cin, line))
+    {
+        const std::vector<std::string> arguments = splitArguments(line);
+
+        if (arguments.size() == 0)
+            continue;
+
+        removeChangedGenerics(irCache, genericsMap, genericHashes);
+
+        /* Output is collected so the exit code line can be put on a line of its own,
+            the printers do not always end their output with a new line */
+        std::ostringstream output;
+        std::streambuf* stdoutBuffer = std::cout.rdbuf(output.rdbuf());
+
+        const int exitCode = compile(arguments, irCache, genericsMap);
+
+        std::cout.rdbuf(stdoutBuffer);
+
+        recordGenericHashes(irCache, genericsMap, genericHashes);
+        timer::reset();
+        memory::reset();
+        monomorphizer::resetInstantiationStats();
+        icode::resetSymbols();
+        icode::resetTypes();
+
+        std::string response = output.str();
+
+        if (response.size() != 0 && response.back() != '\n')
+            response += '\n';
+
+        std::cout << response;
+        pp::println("shtkc-serve: exit " + std::to_string(exitCode));
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::vector<std::string> arguments(argv + 1, argv + argc);
+
+    if (arguments.size() == 1 && arguments[0] == "-version")
+    {
+        pp::println(VERSION);
+        return EXIT_SUCCESS;
+    }
+
+    if (arguments.size() == 1 && arguments[0] == "-serve")
+        return serve();
+
+    IRCache irCache(false);
+    monomorphizer::StringGenericASTMap genericsMap;
+
+    return compile(arguments, irCache, genericsMap);
+}
@@ -1,3 +1,7 @@
+import os
+import subprocess
+import tempfile
+
 from tests_runner.framework import Result
 
 from tests_runner.framework import COMPILER_VERSION
@@ -5,11 +9,15 @@ from tests_runner.framework import simple_output_assert
 
 from tests_runner.framework import tester
 
-USAGE_HELP = '''USAGE: shtkc FILE OPTION
+from tests_runner.framework.command import run_command
+from tests_runner.framework.config import COMPILER_EXEC_PATH, TIMEOUT
+
+USAGE_HELP = '''USAGE: shtkc FILE OPTION [ADDITIONAL OPTIONS]
 
 Available options:
     -c               Create debug executable
     -release         Create release executable
+    -release-lto     Create release executable with whole program optimization
     -ast             Print parse tree
     -ir              Print ShnooTalk IR
     -icode           Print ShnooTalk IR, but only the icode
@@ -29,7 +37,25 @@ Cross compilation options for release executable:
     -wasm32
     -wasm64
 
+Additional options for creating executables:
+    -j N             Generate functions and object files using N parallel jobs
+    -cache           Reuse cached IR and object files of unchanged modules
+    -march=native    Generate code for the host CPU and its features
+    -mcpu=CPU        Generate code for the given CPU
+    -mattr=FEATURES  Enable or disable target features, like +avx2,-fma
+    -O0 to -O3       Set optimization level, default is -O0 for debug and -O3 for release
+    -Os, -Oz         Optimize for size, -Oz more aggressively
+    -fprofile-generate
+                     Instrument optimized code to write a profile when run
+    -fprofile-use=FILE
+                     Use profile FILE created with llvm-profdata to guide optimization
+    -time-phases     Print time taken by each compiler phase
+    -time-trace=FILE Write time taken by each compiler phase to FILE as a Chrome trace
+    -mem-report      Print peak memory and approximate size of compiler data structures
+
 Use shtkc -version for compiler version
+Use shtkc -batch FILE... OPTION [ADDITIONAL OPTIONS] to create executables for many files at once
+Use shtkc -serve to read compile requests from stdin, one per line
 '''
 
 FILE_IO_ERROR = "File I/O error\n"
@@ -61,3 +87,466 @@ def too_many_args() -> Result:
 @tester.single("compiler/tests/compiler")
 def file_does_not_exists() -> Result:
     return simple_output_assert(["NoExist.shtk", "-c"], FILE_IO_ERROR, True)
+
+
+@tester.single("compiler/tests/compiler")
+def parallel_jobs() -> Result:
+    return simple_output_assert(["TestModules/Math.shtk", "-c", "-j", "4"], "", False)
+
+
+@tester.single("compiler/tests/compiler")
+def invalid_jobs() -> Result:
+    return simple_output_assert(["TestModules/Math.shtk", "-c", "-j", "0"], USAGE_HELP, True)
+
+
+@tester.single("compiler/tests/compiler")
+def release_lto() -> Result:
+    return simple_output_assert(["TestModules/Math.shtk", "-release-lto"], "", False)
+
+
+@tester.single("compiler/tests/compiler")
+def release_lto_keeps_module_objects() -> Result:
+    simple_output_assert(["TestModules/Math.shtk", "-c"], "", False)
+    result = simple_output_assert(["TestModules/Math.shtk", "-release-lto"], "", False)
+
+    # The whole program object goes to _obj/_lto, objects of the earlier build are left as they are
+    object_files = ["_obj/TestModules_Vector_shtk.o", "_obj/_lto/TestModules_Math_shtk.o"]
+    missing_files = [file_name for file_name in object_files if not os.path.exists(file_name)]
+
+    if missing_files:
+        return Result.failed(" ".join(missing_files), " ".join(object_files))
+
+    return result
+
+
+@tester.single("compiler/tests/compiler")
+def release_lto_with_jobs() -> Result:
+    return simple_output_assert(
+        ["TestModules/Math.shtk", "-release-lto", "-j", "2"],
+        "-cache and -j can not be used with -release-lto\n", True
+    )
+
+
+@tester.single("compiler/tests/compiler")
+def release_lto_with_cache() -> Result:
+    return simple_output_assert(
+        ["TestModules/Math.shtk", "-release-lto", "-cache"],
+        "-cache and -j can not be used with -release-lto\n", True
+    )
+
+
+@tester.single("compiler/tests/compiler")
+def native_cpu() -> Result:
+    return simple_output_assert(["TestModules/Math.shtk", "-release", "-march=native"], "", False)
+
+
+@tester.single("compiler/tests/compiler")
+def explicit_cpu_and_features() -> Result:
+    return simple_output_assert(
+        ["TestModules/Math.shtk", "-linux-x86_64", "-mcpu=haswell", "-mattr=-avx2"],
+        "", False
+    )
+
+
+@tester.single("compiler/tests/compiler")
+def invalid_cpu() -> Result:
+    return simple_output_assert(
+        ["TestModules/Math.shtk", "-linux-x86_64", "-mcpu=invalid"],
+        "LLVM ERROR: Unknown CPU invalid for target x86_64-linux-gnu\n\nTestModules/Math.shtk\n", True
+    )
+
+
+@tester.single("compiler/tests/compiler")
+def debug_optimization_level() -> Result:
+    return simple_output_assert(["TestModules/Math.shtk", "-c", "-O1"], "", False)
+
+
+@tester.single("compiler/tests/compiler")
+def size_optimization_level() -> Result:
+    return simple_output_assert(["TestModules/Math.shtk", "-release", "-Oz"], "", False)
+
+
+@tester.single("compiler/tests/compiler")
+def release_optimization_level_o0() -> Result:
+    _, expected_output, _ = run_command([COMPILER_EXEC_PATH, "TestModules/Math.shtk", "-llvm"])
+    return simple_output_assert(["TestModules/Math.shtk", "-llvm-release", "-O0"], expected_output, False)
+
+
+@tester.single("compiler/tests/compiler")
+def release_target_before_optimization() -> Result:
+    _, output, exit_code = run_command(
+        [COMPILER_EXEC_PATH, "TestModules/Math.shtk", "-llvm-release", "-mcpu=haswell"]
+    )
+
+    # The optimizer only sees the CPU and its features through the target of the module
+    if exit_code != 0 or "target datalayout" not in output or "target triple" not in output:
+        return Result.failed(output, "target datalayout and target triple in output")
+
+    return Result.passed(output)
+
+
+@tester.single("compiler/tests/compiler")
+def profile_generate() -> Result:
+    return simple_output_assert(["TestModules/Math.shtk", "-release", "-fprofile-generate"], "", False)
+
+
+@tester.single("compiler/tests/compiler")
+def profile_use_missing_file() -> Result:
+    return simple_output_assert(
+        ["TestModules/Math.shtk", "-release", "-fprofile-use=DoesNotExist.profdata"],
+        "Could not read profile DoesNotExist.profdata: No such file or directory\n", True
+    )
+
+
+@tester.single("compiler/tests/compiler")
+def profile_without_optimization() -> Result:
+    return simple_output_assert(
+        ["TestModules/Math.shtk", "-c", "-fprofile-generate"],
+        "Profile options need an optimization level above -O0\n", True
+    )
+
+
+@tester.single("compiler/tests/compiler")
+def object_cache() -> Result:
+    # First compile populates the cache if it is not already populated
+    simple_output_assert(["TestModules/Math.shtk", "-c", "-cache"], "", False)
+
+    return simple_output_assert(
+        ["TestModules/Math.shtk", "-c", "-cache", "-j", "2"],
+        "Object cache: 2 hit(s), 0 miss(es)\n", False
+    )
+
+
+@tester.single("compiler/tests/compiler")
+def ir_cache() -> Result:
+    _, expected_output, _ = run_command([COMPILER_EXEC_PATH, "TestModules/Math.shtk", "-ir-all"])
+
+    # First compile populates the cache if it is not already populated
+    simple_output_assert(["TestModules/Math.shtk", "-ir-all", "-cache"], expected_output, False)
+
+    return simple_output_assert(["TestModules/Math.shtk", "-ir-all", "-cache"], expected_output, False)
+
+
+@tester.single("compiler/tests/compiler")
+def time_phases() -> Result:
+    _, output, exit_code = run_command([COMPILER_EXEC_PATH, "TestModules/Math.shtk", "-c", "-time-phases"])
+
+    # Timings change every run, so only the phase names are checked
+    phase_table = output.split("\n\n")[0]
+    phase_names = "\n".join(line[:20].strip() for line in phase_table.splitlines())
+
+    expected_phase_names = "\n".join([
+        "Phase",
+        "Lexing",
+        "Parsing",
+        "Symbol generation",
+        "Function generation",
+        "LLVM translation",
+        "Object emission",
+        "Total",
+    ])
+
+    if exit_code != 0 or phase_names != expected_phase_names:
+        return Result.failed(phase_names, expected_phase_names)
+
+    return Result.passed(output)
+
+
+@tester.single("compiler/tests/compiler")
+def instantiation_memo() -> Result:
+    _, output, exit_code = run_command([COMPILER_EXEC_PATH, "GenericAutoType.shtk", "-icode", "-time-phases"])
+
+    # The generic is instantiated once, every other use of it with the same types is a hit
+    memo_line = output.splitlines()[-1]
+    expected_memo_line = "Instantiation memo: 4 hits, 1 misses"
+
+    if exit_code != 0 or memo_line != expected_memo_line:
+        return Result.failed(memo_line, expected_memo_line)
+
+    return Result.passed(output)
+
+
+@tester.single("compiler/tests/compiler")
+def mem_report() -> Result:
+    _, output, exit_code = run_command([COMPILER_EXEC_PATH, "TestModules/Math.shtk", "-c", "-mem-report"])
+
+    # Sizes change with the platform and allocator, so only the report layout is checked
+    sections = output.split("\n\n")
+    headings = [section.splitlines()[0].split()[0] if section else "" for section in sections]
+
+    expected_headings = ["Peak", "Phase", "Module", "Operand"]
+
+    if exit_code != 0 or headings != expected_headings or "TestModules/Math.shtk" not in sections[2]:
+        return Result.failed(output, "\n\n".join(expected_headings))
+
+    return Result.passed(output)
+
+
+@tester.single("compiler/tests/compiler")
+def batch() -> Result:
+    return simple_output_assert(
+        ["-batch", "ExternString.shtk", "DefineImport.shtk", "-c"],
+        "ExternString.shtk: _obj/ExternString_shtk.o _obj/TestModules_RandomDefine_shtk.o\n"
+        "DefineImport.shtk: _obj/DefineImport_shtk.o _obj/TestModules_RandomDefine_shtk.o\n", False
+    )
+
+
+@tester.single("compiler/tests/compiler")
+def batch_used_root_module() -> Result:
+    # Vector is first generated as a module used by GenericsPairTest, then as a root module
+    _, _, exit_code = run_command(
+        [COMPILER_EXEC_PATH, "-batch", "GenericsPairTest.shtk", "TestModules/Vector.shtk", "-c"]
+    )
+    _, output, _ = run_command(["nm", "_obj/TestModules_Vector_shtk.o"])
+
+    if exit_code != 0 or "_fn_TestModules_Vector_shtk_isUnitVector" not in output:
+        return Result.failed(output, "_fn_TestModules_Vector_shtk_isUnitVector")
+
+    return Result.passed(output)
+
+
+@tester.single("compiler/tests/compiler")
+def demand_driven_functions() -> Result:
+    # Functions of used modules that are never called are not translated
+    _, _, exit_code = run_command([COMPILER_EXEC_PATH, "GenericsPairTest.shtk", "-c"])
+    _, output, _ = run_command(["nm", "_obj/TestModules_Vector_shtk.o"])
+
+    if exit_code != 0 or "_fn_TestModules_Vector_shtk_setVec" not in output or "isUnitVector" in output:
+        return Result.failed(output, "_fn_TestModules_Vector_shtk_setVec")
+
+    return Result.passed(output)
+
+
+def write_modules(directory: str, modules: dict) -> None:
+    # Modules are used by their path from the working directory, DIR/ stands for the directory
+    for name, source in modules.items():
+        with open(os.path.join(directory, name), "w") as module_file:
+            module_file.write(source.replace("DIR/", directory + "/"))
+
+
+@tester.single()
+def undemanded_function_errors() -> Result:
+    # A function that is never called is not translated, but its errors are reported for every option
+    with tempfile.TemporaryDirectory() as directory:
+        write_modules(directory, {
+            "Main.shtk": 'use "DIR/Used.shtk" as u\n\n' +
+                         "fn main() -> int\n{\n    println(u::called())\n    return 0\n}\n",
+            "Used.shtk": "fn called() -> int\n{\n    return 1\n}\n\nfn notCalled() -> int\n{\n    return 1.5\n}\n",
+        })
+
+        _, expected_output, _ = run_command([COMPILER_EXEC_PATH, os.path.join(directory, "Main.shtk"), "-ir"])
+        _, output, exit_code = run_command([COMPILER_EXEC_PATH, os.path.join(directory, "Main.shtk"), "-c"])
+
+    if exit_code == 0 or "return 1.5" not in output or output != expected_output:
+        return Result.failed(output, expected_output)
+
+    return Result.passed(output)
+
+
+GENERIC_FUNCTIONS_SOURCE = "generic T\n\nfn first(a: T) -> T\n{\n    return a\n}\n\n" + \
+    "fn second(a: T, b: T) -> T\n{\n    return a + b\n}\n"
+
+
+@tester.single()
+def undemanded_generic_function_errors() -> Result:
+    # A function of an instantiated module is generated only once it is called, so an error that depends
+    # on the type arguments is not reported for a function that is never called, whatever the option
+    with tempfile.TemporaryDirectory() as directory:
+        write_modules(directory, {
+            "Main.shtk": 'from "DIR/Gen.shtk" use first\n\nstruct Foo {}\n\n' +
+                         "fn main() -> int\n{\n    var a: Foo\n    var b: Foo = first[Foo](a)\n    return 0\n}\n",
+            "Gen.shtk": GENERIC_FUNCTIONS_SOURCE,
+        })
+
+        for option in ["-c", "-ir-all", "-icode-all"]:
+            _, output, exit_code = run_command([COMPILER_EXEC_PATH, os.path.join(directory, "Main.shtk"), option])
+
+            if exit_code != 0 or "second" in output:
+                return Result.failed(output, "")
+
+    return Result.passed(output)
+
+
+@tester.single()
+def cached_partial_instantiation() -> Result:
+    # A cached module holds the bodies its compile demanded, a compile that calls another function of
+    # the same instantiation generates it again instead of loading it from the cache
+    with tempfile.TemporaryDirectory() as directory:
+        write_modules(directory, {
+            "First.shtk": 'use "DIR/Used.shtk" as u\n\n' +
+                          "fn main() -> int\n{\n    println(u::callFirst())\n    return 0\n}\n",
+            "Second.shtk": 'use "DIR/Used.shtk" as u\nfrom "DIR/Gen.shtk" use second\n\n' +
+                           "fn main() -> int\n{\n    println(u::callFirst() + second[int](1, 2))\n    return 0\n}\n",
+            "Used.shtk": 'from "DIR/Gen.shtk" use first\n\nfn callFirst() -> int\n{\n    return first[int](1)\n}\n',
+            "Gen.shtk": GENERIC_FUNCTIONS_SOURCE,
+        })
+
+        second_path = os.path.join(directory, "Second.shtk")
+        _, expected_output, _ = run_command([COMPILER_EXEC_PATH, second_path, "-icode-all"])
+
+        run_command([COMPILER_EXEC_PATH, os.path.join(directory, "First.shtk"), "-icode-all", "-cache"])
+        _, output, exit_code = run_command([COMPILER_EXEC_PATH, second_path, "-icode-all", "-cache"])
+
+    if exit_code != 0 or "second" not in output or output != expected_output:
+        return Result.failed(output, expected_output)
+
+    return Result.passed(output)
+
+
+@tester.single("compiler/tests/compiler")
+def parallel_functions() -> Result:
+    # Functions are generated by worker threads, the IR is the same as with one job
+    _, expected_output, _ = run_command([COMPILER_EXEC_PATH, "CustomOperator.shtk", "-icode-all"])
+
+    return simple_output_assert(["CustomOperator.shtk", "-icode-all", "-j", "4"], expected_output, False)
+
+
+@tester.single()
+def parallel_shared_strings() -> Result:
+    # Functions using the same string literal get the key of the first one, whichever worker generates it
+    with tempfile.TemporaryDirectory() as directory:
+        source_path = os.path.join(directory, "Many.shtk")
+
+        with open(source_path, "w") as source_file:
+            for i in range(200):
+                source_file.write('fn f%d()\n{\n    println("hello shared")\n}\n\n' % i)
+
+            source_file.write("fn main() -> int\n{\n    f0()\n    return 0\n}\n")
+
+        _, expected_output, _ = run_command([COMPILER_EXEC_PATH, source_path, "-ir", "-j", "1"])
+
+        for _ in range(3):
+            _, output, exit_code = run_command([COMPILER_EXEC_PATH, source_path, "-ir", "-j", "8"])
+
+            if exit_code != 0 or output != expected_output:
+                return Result.failed(output, expected_output)
+
+    return Result.passed(output)
+
+
+@tester.single("compiler/tests/compiler")
+def batch_invalid_option() -> Result:
+    return simple_output_assert(["-batch", "ExternString.shtk", "DefineImport.shtk", "-ir"], USAGE_HELP, True)
+
+
+@tester.single("compiler/tests/compiler")
+def serve() -> Result:
+    _, ir_output, _ = run_command([COMPILER_EXEC_PATH, "TestModules/Math.shtk", "-ir-all"])
+
+    if not ir_output.endswith("\n"):
+        ir_output += "\n"
+
+    # Second request reuses the modules generated by the first
+    requests = "TestModules/Math.shtk -ir-all\nTestModules/Math.shtk -ir-all\n\nTestModules/Math.shtk\n"
+
+    expected_output = (ir_output + "shtkc-serve: exit 0\n") * 2 + USAGE_HELP + "shtkc-serve: exit 1\n"
+
+    try:
+        subp = subprocess.run(
+            [COMPILER_EXEC_PATH, "-serve"],
+            input=requests.encode("utf-8"),
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            timeout=TIMEOUT
+        )
+    except subprocess.TimeoutExpired:
+        return Result.timedout()
+
+    output = subp.stdout.decode("utf-8")
+
+    if subp.returncode != 0 or output != expected_output:
+        return Result.failed(output, expected_output)
+
+    return Result.passed(output)
+
+
+def serve_request(subp: subprocess.Popen, request: str) -> str:
+    subp.stdin.write((request + "\n").encode("utf-8"))
+    subp.stdin.flush()
+
+    response = ""
+
+    while not response.endswith("\n") or not response.splitlines()[-1].startswith("shtkc-serve: exit"):
+        line = subp.stdout.readline().decode("utf-8")
+
+        if line == "":
+            break
+
+        response += line
+
+    return response
+
+
+@tester.single()
+def serve_same_size_edit() -> Result:
+    # An editor saving through a temporary file and a rename, within the same second and
+    # without changing the size, must still give the new source on the next request
+    with tempfile.TemporaryDirectory() as directory:
+        main_source = 'use "Value.shtk" as v\n\nfn main() -> int\n{\n    println(v::value())\n    return 0\n}\n'
+        value_source = "fn value() -> int\n{\n    return %d\n}\n"
+
+        with open(os.path.join(directory, "Main.shtk"), "w") as main_file:
+            main_file.write(main_source)
+
+        with open(os.path.join(directory, "Value.shtk"), "w") as value_file:
+            value_file.write(value_source % 7)
+
+        subp = subprocess.Popen(
+            [COMPILER_EXEC_PATH, "-serve"],
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            cwd=directory
+        )
+
+        try:
+            first_output = serve_request(subp, "Main.shtk -icode-all")
+
+            with open(os.path.join(directory, "Value.shtk.tmp"), "w") as value_file:
+                value_file.write(value_source % 3)
+
+            os.replace(os.path.join(directory, "Value.shtk.tmp"), os.path.join(directory, "Value.shtk"))
+
+            second_output = serve_request(subp, "Main.shtk -icode-all")
+        finally:
+            subp.stdin.close()
+            subp.wait(timeout=TIMEOUT)
+
+    if "autoInt 7" not in first_output or "autoInt 3" not in second_output or "autoInt 7" in second_output:
+        return Result.failed(second_output, "autoInt 3")
+
+    return Result.passed(second_output)
+
+
+@tester.single()
+def serve_frees_interned_names() -> Result:
+    # Names and types interned by a request are freed after it, compiling a file again after
+    # compiling another one interns as many as the first time
+    with tempfile.TemporaryDirectory() as directory:
+        with open(os.path.join(directory, "First.shtk"), "w") as first_file:
+            first_file.write("fn first() -> int\n{\n    return 1\n}\n\nfn main() -> int\n{\n    return first()\n}\n")
+
+        with open(os.path.join(directory, "Second.shtk"), "w") as second_file:
+            second_file.write('fn second(x: float) -> float\n{\n    println("second")\n    return x\n}\n')
+
+        subp = subprocess.Popen(
+            [COMPILER_EXEC_PATH, "-serve"],
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            cwd=directory
+        )
+
+        try:
+            outputs = [serve_request(subp, request + " -icode -mem-report")
+                       for request in ["First.shtk", "Second.shtk", "First.shtk"]]
+        finally:
+            subp.stdin.close()
+            subp.wait(timeout=TIMEOUT)
+
+    counts = [[line for line in output.splitlines() if line.startswith("Interned IR names")] for output in outputs]
+
+    if len(counts[0]) != 1 or counts[0] != counts[2] or counts[0] == counts[1]:
+        return Result.failed(outputs[2], "\n".join(counts[0]))
+
+    return Result.passed(outputs[2])